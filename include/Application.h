@@ -10,9 +10,15 @@
 #include <GLFW/glfw3.h>
 
 #include "Config.h"
-#include "Camera.h"
+#include "FrameConstants.h"
+#include "FramePacer.h"
+#include "GpuProfiler.h"
+#include "FrameSource.h"
+#include "LatencyTracker.h"
+#include "RenderTarget.h"
 #include "Shader.h"
 #include "SegmentationModel.h"
+#include "VideoTexture.h"
 
 class Application {
 public:
@@ -26,15 +32,32 @@ private:
     void mainLoop();
     void cleanup();
     bool loadConfig(int argc, char* argv[]);
-    bool initCamera();
+    bool initFrameSource();
     bool initWindow();
+    void initPacing();
     bool initGLAD();
     void initShader();
+    std::unique_ptr<Shader> createShader(size_t index) const;
+    void submitShader(size_t index);
+    bool completeShader(size_t index);
+    void pumpShaderCompiles();
+    void pollShaderReloads();
+    void switchShader(int step);
     void initFonts();
     void initGeometry();
     void initTextures();
+    void initFrameConstants();
+    void writeFrameConstants();
     void handleKey(int key, int action);
     void updateActiveShaderUniforms();
+    void updateRenderTarget();
+    void updateCaptureResolution();
+    void updateVideoLayout(const Shader& shader);
+    void updateVideoLayerScales(const Shader& shader);
+    void updateCellPass();
+    void uploadGlyphBits();
+    int runGlyphBenchmark();
+    void printUploadStats() const;
     void reloadConfiguration();
     void reloadFontTexture();
     const FontProfile& getCurrentFontProfile() const;
@@ -49,17 +72,51 @@ private:
     std::filesystem::file_time_type lastConfigWriteTime;
 
     GLuint VAO = 0, VBO = 0, EBO = 0;
-    GLuint videoTexture = 0;
+    std::unique_ptr<VideoTexture> videoTexture;
+    // What the shaders draw into, blitted to the window each frame
+    std::unique_ptr<RenderTarget> renderTarget;
+    RenderTarget::Upscale upscale = RenderTarget::Upscale::Linear;
     GLuint fontTexture = 0;
-    GLuint maskTexture = 0;
+    GLuint glyphBuffer = 0; // Bit-packed glyphs of the current font when glyph_bits is on
+    GLuint maskTexture = 0; // Segmentation logits at model resolution
+    // Uniform block every program reads (shaders/include/frame.glsl)
+    FrameConstants frameConstants;
+    GLuint frameConstantsBuffer = 0;
 
-    std::unique_ptr<Camera> camera;
+    // One source per camera, each with its own capture thread; index 0 is
+    // the primary camera that sizes the window and feeds segmentation.
+    std::vector<std::unique_ptr<FrameSource>> frameSources;
+    cv::Size gridSize = cv::Size(1, 1);
+    std::unique_ptr<LatencyTracker> latencyTracker;
+    std::unique_ptr<FramePacer> framePacer;
+    std::unique_ptr<GpuProfiler> gpuProfiler;
     std::vector<std::unique_ptr<Shader>> shaders;
+    // Compute pass that fills the cell texture when cell_grid is "gpu"
+    std::unique_ptr<Shader> cellGridProgram;
     std::vector<std::string> shaderNames;
+    // Per entry of `shaders`, which is null until the program is submitted
+    std::vector<std::string> shaderPaths;
+    std::string shaderDefines;
+    bool shaderCompilesPending = false;
+    // Hot reload: the newest source write time each entry was built from,
+    // and the rebuild in flight after it changed.
+    std::vector<std::filesystem::file_time_type> shaderWriteTimes;
+    std::vector<std::unique_ptr<Shader>> shaderReloads;
+    static constexpr double kShaderPollSeconds = 0.25;
+    double lastShaderPollTime = 0.0;
+    // Per entry of `shaders`: a per-cell compute program (shaders/cell/*.comp)
+    // whose cell buffer glyphExpandShader draws, rather than a full-screen shader.
+    std::vector<bool> shaderIsCellPass;
+    std::unique_ptr<Shader> glyphExpandShader;
+    GLuint cellBuffer = 0;
+    cv::Size cellPassGrid;
     int currentShaderIndex = 0;
 
     std::unique_ptr<fs::SegmentationModel> segmentationModel;
     bool currentShaderUsesMask = false;
+    // Which video textures the current shader reads; the others stay stale.
+    bool currentShaderUsesFrames = true;
+    bool currentShaderUsesCells = false;
     
 
     // Font-related members
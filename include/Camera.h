@@ -1,20 +1,34 @@
 #pragma once
 
-#include <opencv2/opencv.hpp>
+#include <memory>
 
-class Camera {
+#include "CaptureBackend.h"
+#include "Config.h"
+#include "ThreadedFrameSource.h"
+
+// A live camera. Device access goes through the CaptureBackend chosen by
+// CameraSettings::backend; capture runs on the ThreadedFrameSource thread.
+class Camera : public ThreadedFrameSource {
 public:
-    Camera(int deviceID = 0, int width = 1920, int height = 1080);
-    ~Camera();
+    explicit Camera(const CameraSettings& settings);
+    ~Camera() override;
+
+    bool isOpened() const override;
+
+    int getWidth() const override;
+    int getHeight() const override;
+    PixelFormat getPixelFormat() const override;
+
+    void setTargetResolution(int width, int height) override;
 
-    bool isOpened() const;
-    bool read(cv::Mat& frame);
-    
-    int getWidth() const;
-    int getHeight() const;
+protected:
+    bool produce(Frame& frame) override;
+    void recycle(Frame& frame) override;
+    void interruptProducer() override;
+    bool keepsSlotBuffers() const override;
 
 private:
-    cv::VideoCapture cap;
-    int frameWidth;
-    int frameHeight;
+    std::unique_ptr<CaptureBackend> backend;
+    int frameWidth = 0;
+    int frameHeight = 0;
 };
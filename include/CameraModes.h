@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "V4L2Device.h"
+
+// One format / frame size / frame rate combination a V4L2 device can stream.
+struct CameraMode {
+    uint32_t fourcc = 0;
+    int width = 0;
+    int height = 0;
+    double fps = 0.0; // 0 if the driver does not report frame intervals
+};
+
+// Lists every mode the device offers in a format the renderer can use
+// (YUYV, NV12, BGR24, MJPEG). Stepwise and continuous ranges are narrowed to
+// the size and rate closest to `settings`. Empty if the driver can't
+// enumerate.
+std::vector<CameraMode> enumerateCameraModes(V4L2Device& device, const CameraSettings& settings);
+
+// Picks the mode that reaches settings.width x height at settings.fps for
+// the lowest cost of getting frames onto the GPU, restricted to
+// settings.pixelFormat unless that is "auto". When nothing reaches the
+// target, frame rate is kept over resolution. Returns false if no mode fits.
+bool chooseCameraMode(const std::vector<CameraMode>& modes, const CameraSettings& settings, CameraMode& chosen);
+
+// Prints every mode of the configured device, marking the one
+// chooseCameraMode() would pick. Used by --list-modes.
+void printCameraModes(const CameraSettings& settings);
+
+// The device node for a camera: settings.devicePath or /dev/video<deviceID>.
+std::string cameraDevicePath(const CameraSettings& settings);
+
+std::string fourccToString(uint32_t fourcc);
+// Maps a [camera] format name to its fourcc; 0 for "auto".
+uint32_t fourccFromName(const std::string& name);
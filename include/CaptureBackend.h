@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Frame.h"
+
+// A source of raw camera frames driven by Camera's capture thread.
+class CaptureBackend {
+public:
+    virtual ~CaptureBackend() = default;
+
+    virtual bool isOpened() const = 0;
+
+    // Fills `frame` with the next captured image, reusing frame.image's
+    // buffer where possible. A backend may instead point frame.image at memory
+    // it owns (e.g. a mapped driver buffer); that memory stays valid until
+    // release() is called with the same frame.
+    virtual bool grab(Frame& frame) = 0;
+    virtual void release(Frame& frame) {}
+    // True if grab() writes into frame.image's own buffer, so it is worth preallocating.
+    virtual bool fillsFrameStorage() const { return true; }
+    // True if grab() trades frame.image's buffer for one of its own instead
+    // of writing into it, so the buffer can't live in caller-provided memory.
+    virtual bool swapsFrameStorage() const { return false; }
+    // Called from another thread to make a blocked grab() return false soon.
+    virtual void interrupt() {}
+    // The smallest frame size the renderer currently needs. Backends that can
+    // decode more cheaply at reduced scale may deliver frames down to it.
+    virtual void setTargetResolution(int width, int height) {}
+
+    virtual int getWidth() const = 0;
+    virtual int getHeight() const = 0;
+    virtual PixelFormat getPixelFormat() const { return PixelFormat::BGR; }
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include "Frame.h"
+
+// Area-averages a frame down to one pixel per character cell, so the
+// renderer uploads a few kilobytes of cell colours instead of the whole
+// frame, and each cell gets the mean of everything it covers rather than a
+// point sample. BGR, YUYV and NV12 frames are reduced from their own planes;
+// only the cell means are converted to BGR. Rows of a cell are summed with
+// AVX2 (picked at run time), SSE2 or NEON; bands of cell rows run in
+// parallel.
+class CellGridReducer {
+public:
+    // Writes a ceil(extent) CV_8UC4 image into `cells`: the average BGR, and
+    // the Rec. 709 luma of that average in alpha, which is what the ASCII
+    // shaders pick characters by. `extent` is the fractional character grid
+    // the shaders index by, so cell i spans pixels
+    // [i * size / extent, (i + 1) * size / extent), the last cell is cut off
+    // at the frame edge, and a cell smaller than a pixel still takes the one
+    // it starts in. shaders/comp/cell_grid.comp uses the same spans.
+    static void reduce(const Frame& frame, cv::Size2f extent, cv::Mat& cells);
+};
@@ -16,11 +16,144 @@ struct FontProfile {
     float numChars   = 10.0f;
 };
 
+struct CameraSettings {
+    int deviceID = 0;
+    int width = 1920;
+    int height = 1080;
+    // Frame rate to negotiate; the mode chosen must reach it if any can.
+    double fps = 30.0;
+    // "opencv" captures through cv::VideoCapture, "v4l2" through the native mmap backend
+    std::string backend = "opencv";
+    // Device node for the v4l2 backend; defaults to /dev/video<deviceID>.
+    // "fake:<file>" streams raw frames from a file instead of a real camera.
+    std::string devicePath;
+    // Pixel format requested from the camera. "auto" picks the cheapest mode
+    // that reaches width x height at fps among those the driver lists. With
+    // the v4l2 backend "yuyv", "nv12" and "bgr24" stay in this format all the
+    // way to the GPU; "mjpeg" is decoded to BGR on a pool of decodeThreads
+    // workers (0 picks one per core, up to 4).
+    std::string pixelFormat = "auto";
+    int bufferCount = 6;
+    int decodeThreads = 0;
+    // Blend weight of this camera in the "layered" layout.
+    float opacity = 1.0f;
+};
+
+// How several cameras share the window: "grid" tiles them left to right,
+// top to bottom; "layered" blends them all over the full window.
+struct LayoutSettings {
+    std::string mode = "grid";
+    // Grid columns; 0 picks a near-square grid for the camera count.
+    int columns = 0;
+};
+
+// How frames get onto the GPU.
+struct RenderSettings {
+    // Pixel buffer objects per video layer that frames are staged through,
+    // so the CPU fills one while the GPU still copies from another. 0
+    // uploads synchronously from client memory.
+    int uploadBuffers = 3;
+    // Let sources that fill their own frame buffers (synthetic, video files,
+    // OpenCV capture) write straight into persistently mapped GPU buffers,
+    // which skips the staging copy entirely.
+    bool persistentMapping = true;
+    // How shaders that call sampleCell() get their per-cell colours: "cpu"
+    // averages each frame down on the CPU and uploads only that, "gpu"
+    // uploads the frame and reduces it with a compute pass, "off" samples
+    // the frame at each cell centre. Read at startup, since it decides how
+    // the shaders are compiled.
+    std::string cellGrid = "cpu";
+    // Look glyphs up in one-bit masks packed from the atlas (GlyphBits)
+    // instead of sampling the atlas texture. Glyph edges become hard.
+    // Read at startup like cellGrid.
+    bool glyphBits = false;
+    // Save linked shader programs and load them on later runs instead of
+    // compiling. An empty directory means $XDG_CACHE_HOME/frame_shader
+    // (~/.cache/frame_shader).
+    bool shaderCache = true;
+    std::string shaderCacheDir;
+    // Internal resolution the shaders render at before being scaled to the
+    // window; 0 takes the first source's width or height. snapToCells
+    // rounds it down to whole character cells of the current font.
+    int renderWidth = 0;
+    int renderHeight = 0;
+    bool snapToCells = false;
+    // How the render is scaled to the window: "linear", "nearest", or
+    // "integer" (the largest whole multiple that fits, centred).
+    std::string upscale = "linear";
+};
+
+// Where frames come from. Everything except "camera" gives reproducible
+// input for benchmarking and headless runs.
+struct SourceSettings {
+    // "camera", "video" (a file), "images" (a directory of stills, in name
+    // order), "replay" (a file written with record_path) or "synthetic" (a
+    // generated test pattern)
+    std::string type = "camera";
+    std::string path;
+    // Playback rate for video, images, replay and synthetic; 0 uses the
+    // file's own timing (video, replay) or 30 fps.
+    double fps = 0.0;
+    // When false, file and synthetic sources produce frames as fast as they can.
+    bool paced = true;
+    // Synthetic only: how far the pattern moves per frame, in pixels. Frame
+    // content depends only on the frame number, so runs are reproducible.
+    float motion = 4.0f;
+    // Images only: how many upcoming stills to decode ahead of playback.
+    int prefetch = 4;
+    // Frames whose tile averages all stay within this many 8-bit levels of
+    // the last changed frame count as static: their upload and segmentation
+    // are skipped. 0 treats every frame as new.
+    float staticTolerance = 2.0f;
+    // When set, every frame the first source produces is written here with
+    // its timestamp, for bit-exact playback with the "replay" source.
+    std::string recordPath;
+};
+
+// When frames are presented and when their input is sampled.
+struct PacingSettings {
+    // Swap interval: "on" waits for vertical blank, "off" presents at once
+    // (tearing), "adaptive" waits unless the frame is late, falling back to
+    // "on" where the driver lacks swap_control_tear.
+    std::string vsync = "on";
+    // Frame rate cap, held by sleeping and then spinning for the last
+    // stretch; 0 leaves pacing to vsync.
+    double maxFps = 0.0;
+    // Acquire frames as late as possible: just early enough before the
+    // next present (the max_fps cadence, else the display's refresh) for
+    // the recent frame work to finish, instead of right after the last swap.
+    bool lowLatency = false;
+};
+
+struct StatsSettings {
+    // How often the latency percentiles are printed; 0 only prints them on exit.
+    double latencyReportSeconds = 5.0;
+    // When set, every presented frame's timeline is appended to this CSV file.
+    std::string latencyLogPath;
+    // Time each render pass on the GPU with timer queries, reported per
+    // shader alongside the latency percentiles.
+    bool gpuTimers = true;
+};
+
 struct AppConfig {
-    int cameraDeviceID = 0;
-    int cameraWidth = 1920;
-    int cameraHeight = 1080;
+    // The first (or only) camera. Further cameras come from [camera:1] ..
+    // [camera:3] sections, whose keys override a copy of these settings.
+    CameraSettings camera;
+    std::map<int, std::map<std::string, std::string>> extraCameraOverrides;
+    LayoutSettings layout;
+    RenderSettings render;
+    PacingSettings pacing;
+    SourceSettings source;
+    StatsSettings stats;
     std::string selectedFontProfile = "dejavu_sans_mono-10-8x16";
+    // Shader shown at startup, e.g. "ascii_matrix" or "cell/ascii"; empty
+    // starts with the first one. Only it is compiled before the first frame.
+    std::string selectedShader;
+    // Print the modes of every configured camera and exit (--list-modes).
+    bool listModes = false;
+    // Time the atlas and bit-packed glyph lookups offscreen and exit
+    // (--benchmark-glyphs).
+    bool glyphBenchmark = false;
 
     // Maps a font profile name (e.g., "default") to its specific settings
     std::map<std::string, FontConfig> fontConfigs;
@@ -30,3 +163,5 @@ struct AppConfig {
 
 AppConfig load_configuration(int argc, char* argv[]);
 void load_from_ini(AppConfig& config);
+// Settings for every configured camera, the primary one first.
+std::vector<CameraSettings> camera_settings_list(const AppConfig& config);
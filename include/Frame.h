@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+// Memory layout of Frame::image. The values match the videoFormat constants
+// in shaders/include/video.glsl.
+enum class PixelFormat {
+    BGR = 0,  // CV_8UC3
+    YUYV = 1, // Packed 4:2:2, CV_8UC2
+    NV12 = 2, // Y plane followed by interleaved CbCr at half resolution, CV_8UC1 with height * 3 / 2 rows
+};
+
+// Current time on the steady_clock timeline that frame timestamps use.
+inline int64_t steadyClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A captured frame as it travels from a capture thread to the render loop.
+struct Frame {
+    cv::Mat image;
+    PixelFormat format = PixelFormat::BGR;
+    uint64_t sequence = 0;   // Monotonic capture counter, starting at 1
+    int64_t timestampNs = 0; // Capture time on the CLOCK_MONOTONIC/steady_clock timeline
+    int64_t dequeueNs = 0;   // When the producer thread finished dequeueing (and decoding) it
+    // Advances only when the picture changes noticeably (see
+    // SceneChangeDetector), so equal values mean the GPU copy is still good.
+    uint64_t contentGeneration = 0;
+    int bufferIndex = -1;    // Backend buffer held by this frame, -1 if none
+
+    int width() const { return image.cols; }
+    int height() const { return format == PixelFormat::NV12 ? image.rows * 2 / 3 : image.rows; }
+
+    // The image as BGR: `image` itself if it already is, otherwise converted into `scratch`.
+    const cv::Mat& toBGR(cv::Mat& scratch) const;
+};
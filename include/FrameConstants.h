@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+// CPU side of the FrameConstants uniform block in
+// shaders/include/frame.glsl, laid out as std140. The application writes
+// it into one uniform buffer, bound at binding 0, once per frame.
+struct FrameConstants {
+    float resolution[2] = {0.0f, 0.0f};
+    float charSize[2] = {8.0f, 16.0f};
+    float time = 0.0f;
+    float numChars = 10.0f;
+    int32_t frameIndex = 0;
+    int32_t maskFrameIndex = -1;
+};
+static_assert(sizeof(FrameConstants) == 32, "FrameConstants must match the std140 block in frame.glsl");
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Decides when the render loop starts its next frame. With a frame rate
+// cap, frames start one interval apart. In low-latency mode the start is
+// pushed as late as the recent frame work allows before the next present,
+// so the frame that is drawn is the newest one the cameras had instead of
+// one that waited out the vsync. Waits sleep until close to the deadline
+// and spin the rest, since a sleep can overshoot by a scheduler tick.
+class FramePacer {
+public:
+    // maxFps 0 disables the cap; refreshHz paces low-latency mode when there
+    // is no cap (0 if unknown, which leaves low-latency mode idle).
+    FramePacer(double maxFps, bool lowLatency, double refreshHz);
+
+    // Call after the swap returned at swapNs; blocks until the next frame
+    // should acquire its input.
+    void waitForNextFrame(int64_t swapNs);
+    // Time from acquiring input to submitting the draw of one frame, which
+    // low-latency mode plans the next start around.
+    void recordWork(int64_t startNs, int64_t endNs);
+
+    bool isActive() const { return intervalNs > 0; }
+    int64_t getIntervalNs() const { return intervalNs; }
+
+    // Blocks until deadlineNs on the steady_clock timeline.
+    static void waitUntil(int64_t deadlineNs);
+
+private:
+    // Longest recent work time plus a margin for the swap itself.
+    int64_t plannedWorkNs() const;
+
+    static constexpr size_t kWorkHistory = 32;
+
+    int64_t intervalNs = 0;
+    bool capped = false;
+    bool lowLatency = false;
+    int64_t lastStartNs = 0;
+    int64_t nextPresentNs = 0;
+    std::array<int64_t, kWorkHistory> workNs{};
+    size_t nextWork = 0;
+};
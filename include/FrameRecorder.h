@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Frame.h"
+#include "RecordingFormat.h"
+
+// Writes frames and their capture timestamps to a recording file (see
+// RecordingFormat.h) for bit-exact replay with RecordingSource. append() is
+// called on a capture thread and only copies the pixels into a pooled
+// buffer; a writer thread does the file I/O. When the disk can't keep up,
+// frames are dropped rather than stalling capture, and counted.
+class FrameRecorder {
+public:
+    ~FrameRecorder();
+
+    bool open(const std::string& path);
+    // Thread-safe; frames may come from any one thread at a time.
+    void append(const Frame& frame);
+    // Flushes pending frames, writes the index and closes the file.
+    void close();
+
+private:
+    struct Pending {
+        recording::ChunkHeader header{};
+        std::vector<uint8_t> pixels;
+    };
+
+    void writerLoop();
+    bool writeChunk(const Pending& chunk);
+
+    static constexpr size_t kMaxPending = 8;
+
+    std::FILE* file = nullptr;
+    std::string filePath;
+    uint64_t writeOffset = 0;
+    std::vector<recording::IndexEntry> index; // Writer thread only
+    bool writeFailed = false;                 // Writer thread only
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Pending> pending;
+    std::vector<Pending> freeBuffers;
+    bool closing = false;
+    uint64_t droppedFrames = 0;
+    std::thread writerThread;
+};
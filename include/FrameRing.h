@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Single-producer/single-consumer "latest frame" handoff over a fixed ring of
+// three preallocated slots. The producer always owns one slot to fill, the
+// consumer owns the slot it is currently reading, and the third slot holds the
+// most recently published frame. Neither side ever blocks: publishing replaces
+// a pending frame the consumer has not picked up yet, so the consumer always
+// gets the newest frame and stale ones are counted as dropped.
+template <typename T>
+class FrameRing {
+public:
+    static constexpr int kSlotCount = 3;
+
+    // Producer side: the slot to fill before calling publish().
+    T& writeSlot() { return slots[writeIndex]; }
+
+    // Producer side: hands the write slot to the consumer and takes back a free
+    // one. Returns true if the previously published frame was never consumed.
+    bool publish() {
+        uint8_t previous = pending.exchange(static_cast<uint8_t>(writeIndex | kFreshBit), std::memory_order_acq_rel);
+        writeIndex = previous & kIndexMask;
+        return (previous & kFreshBit) != 0;
+    }
+
+    // Consumer side: swaps in the newest published frame if there is one.
+    // Returns false when nothing new has been published since the last call.
+    bool acquire() {
+        if ((pending.load(std::memory_order_acquire) & kFreshBit) == 0) {
+            return false;
+        }
+        uint8_t previous = pending.exchange(static_cast<uint8_t>(readIndex), std::memory_order_acq_rel);
+        readIndex = previous & kIndexMask;
+        return true;
+    }
+
+    // Consumer side: the slot returned by the last successful acquire().
+    T& readSlot() { return slots[readIndex]; }
+
+    // Direct access for preallocation; only valid before the producer starts.
+    std::array<T, kSlotCount>& allSlots() { return slots; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFreshBit = 0x4;
+
+    std::array<T, kSlotCount> slots{};
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<uint8_t> pending{2};
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Config.h"
+#include "Frame.h"
+
+class FrameRecorder;
+
+// Anything that feeds frames to the render loop: a live camera, a video
+// file, an image sequence or a synthetic pattern. Sources produce frames on
+// their own thread; read() never blocks and always returns the newest one.
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    virtual bool isOpened() const = 0;
+    // False once the source has stopped producing frames.
+    virtual bool isRunning() const = 0;
+
+    // Non-blocking: if a frame newer than the last one returned is available,
+    // points `frame` at it and returns true. The data stays valid until the
+    // next successful call.
+    virtual bool read(Frame& frame) = 0;
+    // Blocks until the first frame arrives or the source stops.
+    bool waitForFrame(Frame& frame);
+
+    // Nominal frame size; frames may be smaller after setTargetResolution().
+    virtual int getWidth() const = 0;
+    virtual int getHeight() const = 0;
+    virtual PixelFormat getPixelFormat() const = 0;
+
+    // The smallest frame the renderer needs (e.g. one pixel per character
+    // cell). Sources that can decode more cheaply at reduced scale may
+    // deliver frames down to this size. Thread-safe.
+    virtual void setTargetResolution(int width, int height) {}
+
+    // How far (in 8-bit levels of a tile average) a frame must differ from
+    // the last changed one to get a new contentGeneration; 0 marks every
+    // frame as changed. Thread-safe.
+    virtual void setChangeTolerance(float tolerance) {}
+
+    // Sources that write every frame into a preallocated buffer per ring
+    // slot can write into memory the renderer provides instead, such as a
+    // persistently mapped GPU buffer the texture is then filled from.
+    // getSlotBytes() is the size of each of the kFrameSlots buffers needed,
+    // or 0 if the source can't; setSlotStorage() hands them over. The memory
+    // must stay valid until the source is destroyed, and a slot may be
+    // rewritten as soon as read() has moved past the frame in it.
+    static constexpr int kFrameSlots = 3;
+    virtual size_t getSlotBytes() const { return 0; }
+    virtual void setSlotStorage(const std::vector<uint8_t*>& slots) {}
+
+    // Appends every frame produced from now on, including ones the render
+    // loop never picks up, to `recorder`; nullptr stops recording.
+    // Thread-safe.
+    virtual void setRecorder(std::shared_ptr<FrameRecorder> recorder) {}
+
+    virtual uint64_t getCapturedFrames() const = 0;
+    virtual uint64_t getDroppedFrames() const = 0;
+    // Frames that kept the previous frame's contentGeneration.
+    virtual uint64_t getUnchangedFrames() const { return 0; }
+
+    // Builds the source selected by config.source.
+    static std::unique_ptr<FrameSource> create(const AppConfig& config);
+    // Like create(), but one source per configured camera (at most
+    // maxSources) when the camera source is selected. Each runs its own
+    // capture thread.
+    static std::vector<std::unique_ptr<FrameSource>> createAll(const AppConfig& config, size_t maxSources);
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// Thresholds a font atlas (glyphs side by side in one row) into one bit
+// per pixel, so shaders can look glyphs up in a small storage buffer
+// instead of fetching from the atlas texture. A 4x8 glyph becomes one
+// 32-bit word, an 8x16 glyph four.
+class GlyphBits {
+public:
+    // Words per glyph. Bit (y * charWidth + x) of a glyph's words is set
+    // where that pixel is ink; row 0 is the top of the atlas image.
+    static int wordsPerGlyph(int charWidth, int charHeight);
+    // Packs numChars glyphs from a BGR or grayscale atlas, reading the red
+    // channel as the shaders do. Pixels from `threshold` up count as ink.
+    static std::vector<uint32_t> pack(const cv::Mat& atlas, int charWidth, int charHeight, int numChars,
+                                      int threshold = 128);
+};
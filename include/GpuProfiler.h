@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <glad/glad.h>
+
+#include "LatencyTracker.h"
+
+// Times the render passes on the GPU with GL_TIME_ELAPSED queries without
+// ever waiting for them. Every frame has its own set of queries in a ring
+// kFramesInFlight deep, and a frame's results are only read when its slot
+// comes round again, by which time the GPU has long finished it. A result
+// that is somehow still pending is dropped rather than waited for. Results
+// go to the LatencyTracker under the shader the frame was drawn with.
+//
+// A pass may be timed in several spans per frame (one per camera, say),
+// which are added up, so the CPU work between them is left out.
+class GpuProfiler {
+public:
+    // A disabled profiler creates no queries and every call does nothing.
+    GpuProfiler(LatencyTracker& tracker, bool enabled);
+    ~GpuProfiler();
+
+    // Starts a frame drawn with `shaderName`, first collecting the results
+    // of the frame that used this slot before.
+    void beginFrame(const std::string& shaderName);
+    // Times the GPU work submitted until end(pass), adding it to whatever
+    // the pass already took this frame. Passes cannot nest: begin() while
+    // another pass runs is ignored, as is end() of a pass that is not
+    // running. Past kMaxSpans spans the pass is not timed for that frame.
+    void begin(LatencyTracker::GpuPass pass);
+    void end(LatencyTracker::GpuPass pass);
+
+    // Pass results that were still pending when collected, implausible, or
+    // missing spans.
+    uint64_t getDroppedResults() const { return droppedResults; }
+
+private:
+    static constexpr int kFramesInFlight = 4;
+    // Enough for an upload and a re-upload of every camera.
+    static constexpr int kMaxSpans = 8;
+
+    struct FrameQueries {
+        std::array<std::array<GLuint, kMaxSpans>, LatencyTracker::GpuPassCount> queries{};
+        std::array<int, LatencyTracker::GpuPassCount> spans{};
+        std::array<bool, LatencyTracker::GpuPassCount> overflowed{};
+        std::string shaderName;
+    };
+
+    void collect(FrameQueries& frame);
+
+    LatencyTracker& tracker;
+    bool enabled = false;
+    std::array<FrameQueries, kFramesInFlight> frames;
+    int currentFrame = -1;
+    int activePass = -1;
+    uint64_t droppedResults = 0;
+};
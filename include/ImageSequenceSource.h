@@ -0,0 +1,38 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Config.h"
+#include "ThreadedFrameSource.h"
+
+// Plays the still images in a directory, in file name order, looping at the
+// end. The next few images are decoded ahead of time on worker threads so
+// disk and decode latency stay off the producer's schedule.
+class ImageSequenceSource : public ThreadedFrameSource {
+public:
+    explicit ImageSequenceSource(const SourceSettings& settings);
+    ~ImageSequenceSource() override;
+
+    bool isOpened() const override;
+
+    int getWidth() const override;
+    int getHeight() const override;
+    PixelFormat getPixelFormat() const override { return PixelFormat::BGR; }
+
+protected:
+    bool produce(Frame& frame) override;
+
+private:
+    void fillPrefetchQueue();
+
+    std::vector<std::string> imagePaths;
+    size_t nextToLoad = 0;
+    size_t prefetchDepth = 1;
+    std::deque<std::future<cv::Mat>> prefetched;
+    int frameWidth = 0;
+    int frameHeight = 0;
+};
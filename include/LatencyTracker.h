@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "Frame.h"
+
+// Timestamps one frame collects on its way from the sensor to the screen, in
+// nanoseconds on the steady_clock timeline. Zero means the stage did not run
+// for this frame (e.g. no inference while the shader ignores the mask).
+struct FrameTimeline {
+    int source = 0;               // Index of the source when several cameras run
+    uint64_t sequence = 0;
+    int64_t captureNs = 0;        // Driver (or arrival) timestamp
+    int64_t dequeueNs = 0;        // Published by the producer thread
+    int64_t acquireNs = 0;        // Picked up by the render loop
+    int64_t uploadNs = 0;         // Texture upload submitted
+    int64_t inferenceStartNs = 0;
+    int64_t inferenceEndNs = 0;
+    int64_t drawSubmitNs = 0;     // Draw call issued
+    int64_t swapNs = 0;           // glfwSwapBuffers returned
+
+    // Starts a timeline for a frame the render loop just acquired.
+    static FrameTimeline begin(const Frame& frame, int source = 0);
+};
+
+// Keeps rolling per-stage latency percentiles over the last few hundred
+// frames, prints them periodically and optionally logs every frame's raw
+// timeline as CSV for offline analysis.
+class LatencyTracker {
+public:
+    enum Stage {
+        Capture,   // capture -> dequeue: driver queue, DQBUF and decode
+        Queue,     // dequeue -> acquire: waiting in the frame ring
+        Upload,    // acquire -> upload
+        Inference, // inference start -> end
+        Draw,      // upload/inference -> draw submit
+        Present,   // draw submit -> swap
+        Total,     // capture -> swap
+        StageCount
+    };
+
+    // GPU passes timed by GpuProfiler, kept per shader since the draw
+    // cost is mostly down to which shader is active.
+    enum GpuPass {
+        GpuUpload,   // Video frames and cell colours
+        GpuCellGrid, // Cell colours reduced from the frames on the GPU
+        GpuMask,     // Segmentation mask upload
+        GpuCells,    // Per-cell compute pass of a cell effect
+        GpuDraw,     // The shader's full-screen draw
+        GpuBlit,     // Render target to window
+        GpuPassCount
+    };
+
+    struct Percentiles {
+        double p50 = 0.0, p95 = 0.0, p99 = 0.0; // Milliseconds
+        size_t samples = 0;
+    };
+
+    explicit LatencyTracker(const StatsSettings& settings);
+    ~LatencyTracker();
+
+    // Adds a completed timeline (swapNs set) to the statistics and the log.
+    void record(const FrameTimeline& timeline);
+    // Adds the time since the previous swap, for the frame pacing line of
+    // the summary. Called once per presented frame, new input or not.
+    void recordPresent(int64_t swapNs);
+    // Adds one pass's GPU time for a frame drawn with `shaderName`.
+    void recordGpu(const std::string& shaderName, GpuPass pass, int64_t ns);
+    // Counts a stage that was skipped because its input had not changed
+    // (static scene). Skip rates are printed with the percentiles.
+    void recordSkip(Stage stage);
+
+    Percentiles getPercentiles(Stage stage) const;
+    // Mean and standard deviation of the recent present intervals, in ms.
+    void getFrameTimeStats(double& mean, double& deviation) const;
+    // Prints the percentile table to stdout.
+    void printSummary() const;
+
+    static const char* stageName(Stage stage);
+    static const char* gpuPassName(GpuPass pass);
+
+private:
+    void addSample(Stage stage, int64_t fromNs, int64_t toNs);
+
+    static constexpr size_t kWindowSize = 600;
+
+    struct Window {
+        std::vector<int64_t> samples; // Circular, at most kWindowSize
+        size_t next = 0;
+    };
+    static void push(Window& window, int64_t sample);
+    static Percentiles percentilesOf(const Window& window);
+
+    std::array<Window, StageCount> windows;
+    Window presentIntervals;
+    std::map<std::string, std::array<Window, GpuPassCount>> gpuWindows;
+    int64_t lastSwapNs = 0;
+    std::array<uint64_t, StageCount> sampleCounts{};
+    std::array<uint64_t, StageCount> skipCounts{};
+
+    std::ofstream log;
+    int64_t reportIntervalNs = 0;
+    int64_t lastReportNs = 0;
+    uint64_t recordedFrames = 0;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "Frame.h"
+
+// Decodes MJPEG frames on a small pool of libjpeg-turbo workers while
+// delivering them strictly in submission order. Compressed data is copied
+// into one of a fixed set of job slots, so the producer can return the
+// capture buffer to the driver immediately; decoded pixels land in a
+// per-slot buffer that is swapped (not copied) into the consumer's frame.
+class MjpegDecoder {
+public:
+    explicit MjpegDecoder(int threadCount);
+    ~MjpegDecoder();
+
+    // Queues a compressed frame. Returns false, dropping it, if every job
+    // slot is still busy.
+    bool submit(const uint8_t* data, size_t size, int64_t timestampNs);
+
+    // Blocks until the next frame in submission order has been decoded and
+    // swaps its pixels into frame.image. Frames that fail to decode are
+    // skipped. Returns false once stop() has been called.
+    bool next(Frame& frame);
+
+    // Wakes up and fails any pending next() call and shuts the workers down.
+    void stop();
+
+    // Lets workers decode at 1/2, 1/4 or 1/8 scale in the DCT domain, as long
+    // as the output stays at least this large. 0x0 always decodes full size.
+    void setMinimumSize(int width, int height);
+
+    uint64_t getDroppedFrames() const;
+    uint64_t getCorruptFrames() const;
+
+private:
+    enum class JobState { Free, Filling, Queued, Decoding, Done, Failed };
+
+    struct Job {
+        std::vector<uint8_t> compressed;
+        size_t compressedSize = 0;
+        cv::Mat decoded;
+        int64_t timestampNs = 0;
+        uint64_t sequence = 0;
+        JobState state = JobState::Free;
+    };
+
+    void workerLoop();
+
+    std::vector<Job> jobs;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable jobFinished;
+    uint64_t nextSubmitSequence = 0;
+    uint64_t nextDeliverSequence = 0;
+    uint64_t droppedFrames = 0;
+    uint64_t corruptFrames = 0;
+    bool stopping = false;
+
+    std::atomic<int> minimumWidth{0};
+    std::atomic<int> minimumHeight{0};
+    std::atomic<int> activeScaleDenom{1};
+};
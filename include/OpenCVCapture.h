@@ -0,0 +1,25 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include "CaptureBackend.h"
+#include "Config.h"
+
+// Captures through cv::VideoCapture, which decodes every frame to BGR. The
+// mode is still chosen from the driver's list when it can be enumerated.
+class OpenCVCapture : public CaptureBackend {
+public:
+    explicit OpenCVCapture(const CameraSettings& settings);
+    ~OpenCVCapture() override;
+
+    bool isOpened() const override;
+    bool grab(Frame& frame) override;
+
+    int getWidth() const override;
+    int getHeight() const override;
+
+private:
+    cv::VideoCapture cap;
+    int frameWidth = 0;
+    int frameHeight = 0;
+};
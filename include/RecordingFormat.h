@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of a frame recording (see FrameRecorder and
+// RecordingSource). All fields are little-endian.
+//
+//   FileHeader                          64 bytes
+//   { ChunkHeader, pixels } x N         each chunk starts on a 64-byte boundary
+//   ChunkHeader (kIndexMagic), IndexEntry x N
+//
+// Pixels are stored tightly packed (rows * cols * elemSize bytes) right after
+// their 64-byte chunk header, so a reader can wrap them in a cv::Mat straight
+// from a memory map. The index is written when the recording is closed and
+// FileHeader::indexOffset patched to point at it; a file without one (the
+// recorder was killed) can still be read by walking the chunks.
+namespace recording {
+
+constexpr char kFileMagic[8] = {'A', 'S', 'C', 'I', 'I', 'R', 'E', 'C'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kFrameMagic = 0x454D5246; // "FRME"
+constexpr uint32_t kIndexMagic = 0x58444E49; // "INDX"
+constexpr uint64_t kAlignment = 64;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;  // sizeof(FileHeader)
+    uint64_t frameCount;   // Valid once indexOffset is set
+    uint64_t indexOffset;  // 0 if the recording was not closed cleanly
+    uint8_t reserved[32];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+
+struct ChunkHeader {
+    uint32_t magic;        // kFrameMagic or kIndexMagic
+    uint32_t headerBytes;  // sizeof(ChunkHeader)
+    uint64_t payloadBytes; // Bytes following this header, before padding
+    int64_t timestampNs;   // Capture time as recorded (steady_clock)
+    uint64_t sequence;     // Frame::sequence at record time
+    int32_t pixelFormat;   // PixelFormat
+    int32_t cvType;        // cv::Mat type, e.g. CV_8UC3
+    int32_t rows;          // cv::Mat rows (NV12 includes the chroma rows)
+    int32_t cols;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(ChunkHeader) == 64, "ChunkHeader must stay 64 bytes");
+
+struct IndexEntry {
+    uint64_t offset;       // File offset of the frame's ChunkHeader
+    int64_t timestampNs;
+};
+static_assert(sizeof(IndexEntry) == 16, "IndexEntry must stay 16 bytes");
+
+inline uint64_t alignUp(uint64_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+} // namespace recording
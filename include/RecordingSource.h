@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "RecordingFormat.h"
+#include "ThreadedFrameSource.h"
+
+// Replays a file written by FrameRecorder, looping at the end. The file is
+// memory-mapped and frames are handed out as cv::Mat headers over the
+// mapping, so playback involves no read() calls and no copies; pixels are
+// exactly what was captured.
+//
+// Paced playback reproduces the recorded frame timing (or a fixed rate when
+// source.fps is set); unpaced playback delivers frames as fast as the
+// consumer takes them, for throughput benchmarks.
+class RecordingSource : public ThreadedFrameSource {
+public:
+    explicit RecordingSource(const SourceSettings& settings);
+    ~RecordingSource() override;
+
+    bool isOpened() const override;
+
+    int getWidth() const override;
+    int getHeight() const override;
+    PixelFormat getPixelFormat() const override;
+
+protected:
+    bool produce(Frame& frame) override;
+    void interruptProducer() override;
+
+private:
+    bool mapFile(const std::string& path);
+    bool readIndex();
+    bool scanChunks();
+    const recording::ChunkHeader* chunkAt(uint64_t offset) const;
+    // Sleeps until the recorded time of `timestampNs` comes round. False if
+    // interrupted.
+    bool waitUntilDue(int64_t timestampNs);
+
+    const uint8_t* mapped = nullptr;
+    size_t mappedBytes = 0;
+    std::vector<recording::IndexEntry> index;
+    size_t nextFrame = 0;
+    int frameWidth = 0;
+    int frameHeight = 0;
+    PixelFormat pixelFormat = PixelFormat::BGR;
+
+    bool followTimestamps = false;
+    std::chrono::steady_clock::time_point playbackStart;
+    int64_t firstTimestampNs = 0;
+    std::mutex pacingMutex;
+    std::condition_variable pacingWake;
+};
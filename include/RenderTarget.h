@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <glad/glad.h>
+#include <opencv2/opencv.hpp>
+
+// The offscreen colour buffer the shaders draw into, at an internal render
+// resolution of its own, and copied to the window with glBlitFramebuffer.
+// That keeps the shading cost and the character grid independent of the
+// window: a 1080p render can fill a 4K display, and resizing the window
+// scales the finished image instead of re-laying out the glyphs.
+class RenderTarget {
+public:
+    // How blitToWindow() scales the render to the window.
+    enum class Upscale {
+        Linear,  // Stretch over the whole window, filtered
+        Nearest, // Stretch over the whole window, unfiltered
+        Integer, // Largest whole multiple that fits, centred and unfiltered
+    };
+
+    RenderTarget() = default;
+    ~RenderTarget();
+
+    // Reallocates the colour buffer when the size changes.
+    void resize(cv::Size newSize);
+    cv::Size getSize() const { return size; }
+
+    // Makes the target the draw framebuffer and sets the viewport to it.
+    void bind() const;
+    // Copies the render into the window's framebuffer, which is left bound.
+    // Integer scaling falls back to Linear when the window is smaller than
+    // the render.
+    void blitToWindow(cv::Size windowSize, Upscale upscale) const;
+
+    // "linear", "nearest" or "integer"; false for anything else.
+    static bool parseUpscale(const std::string& name, Upscale& upscale);
+
+private:
+    GLuint framebuffer = 0;
+    GLuint colorBuffer = 0;
+    cv::Size size;
+};
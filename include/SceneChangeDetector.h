@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Frame.h"
+
+// Decides whether a frame shows anything new compared to the last frame that
+// did. Each frame is reduced to the mean byte value of a grid of tiles over
+// every fourth row (summed with SSE2/NEON where available); the frame counts
+// as changed when any tile mean moves by more than the tolerance, in 8-bit
+// levels. Averaging over a tile absorbs sensor noise, while anything that
+// moves still shifts the tiles it crosses.
+//
+// The reference only advances on a change, so slow drift (a sunset, auto
+// exposure) still accumulates until it crosses the tolerance.
+class SceneChangeDetector {
+public:
+    static constexpr int kTilesX = 16;
+    static constexpr int kTilesY = 9;
+
+    // True if `frame` differs noticeably from the reference, which then
+    // becomes `frame`. A tolerance <= 0 reports every frame as changed.
+    bool hasChanged(const Frame& frame, float tolerance);
+
+private:
+    void computeSignature(const Frame& frame, std::vector<float>& signature);
+
+    std::vector<float> reference;
+    std::vector<float> current;
+    std::vector<uint64_t> tileSums;
+    std::vector<uint64_t> tileCounts;
+    int referenceWidth = 0;
+    int referenceHeight = 0;
+    PixelFormat referenceFormat = PixelFormat::BGR;
+};
@@ -31,8 +31,16 @@ public:
     ~SegmentationModel();
 
     bool init();
+    // Runs the model and returns its raw logits, outputHeight x outputWidth
+    // CV_32F. Sigmoid, threshold and upsampling are left to the caller
+    // (sampleMask() in shaders/include/mask.glsl does them on the GPU).
     cv::Mat infer(const cv::Mat& inputImage);
 
+    int getInputWidth() const { return inputWidth; }
+    int getInputHeight() const { return inputHeight; }
+    int getOutputWidth() const { return outputWidth; }
+    int getOutputHeight() const { return outputHeight; }
+
 private:
     bool loadEngine();
     bool buildEngine();
@@ -1,21 +1,55 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 class Shader {
 public:
     // The shader program ID
-    unsigned int ID;
+    unsigned int ID = 0;
 
-    // Constructor: reads and builds the shader from source files
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // Constructor: reads and builds the shader from source files.
+    // `defines` (e.g. "#define VIDEO_CELLS 1\n") goes right after #version.
+    // A `deferred` program is only submitted to the driver; isReady() and
+    // finish() complete it later.
+    Shader(const char* vertexPath, const char* fragmentPath, const std::string& defines = "", bool deferred = false);
+    // Builds a compute program instead; nullptr if it does not compile. A
+    // deferred one is returned before that is known, so check isLinked()
+    // after finish().
+    static std::unique_ptr<Shader> compute(const char* computePath, const std::string& defines = "",
+                                           bool deferred = false);
+
+    // Lets the driver compile and link on its own threads when it has
+    // KHR_parallel_shader_compile (or the ARB version). Returns whether it
+    // does; without it a deferred program compiles in finish().
+    static bool enableParallelCompile(GLADloadproc load);
+    static bool hasParallelCompile() { return parallelCompile; }
+
+    // Linked programs are saved here with glGetProgramBinary, keyed by their
+    // expanded source and the driver, and loaded instead of compiling on
+    // later runs. Empty (the default) disables the cache.
+    static void setBinaryCacheDirectory(const std::string& directory);
     // Destructor
     ~Shader();
 
     // Activates the shader program
     void use() const;
+    bool isLinked() const;
+    // True once finish() would not block: always without parallel compile.
+    bool isReady() const;
+    // False for a deferred program until finish() has run.
+    bool isComplete() const { return !pending; }
+    // Reports compile and link errors and saves the binary of a deferred
+    // program; does nothing for one that is already complete.
+    void finish();
+    bool isFromBinaryCache() const { return fromBinaryCache; }
+    // Every file the program was built from, includes too.
+    const std::vector<std::filesystem::path>& getSourceFiles() const { return sourceFiles; }
     bool usesUniform(const std::string& name) const;
 
     // Utility uniform functions
@@ -23,8 +57,26 @@ public:
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
     void setVec2(const std::string &name, float v1, float v2) const;
+    void setIVec2(const std::string &name, int v1, int v2) const;
 
 private:
+    Shader() = default;
+
+    static std::string binaryCacheDirectory;
+    static bool parallelCompile;
+    bool fromBinaryCache = false;
+    std::vector<std::filesystem::path> sourceFiles;
+    // Stages of a deferred program, kept for their info logs until finish()
+    std::vector<std::pair<GLuint, std::string>> pendingStages;
+    std::string pendingCacheKey;
+    bool pending = false;
+    // Compiles `stages` (type and source) into ID and links it.
+    void build(const std::vector<std::pair<GLenum, const std::string*>>& stages, const std::string& cacheKey);
+    // Creates ID from a cached binary; false (and no program) on a miss or
+    // when the driver rejects the binary.
+    bool loadBinary(const std::string& key);
+    void saveBinary(const std::string& key) const;
+
     // Caches uniform locations for performance
     mutable std::unordered_map<std::string, GLint> uniformLocationCache;
     GLint getUniformLocation(const std::string &name) const;
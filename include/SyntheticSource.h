@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Config.h"
+#include "ThreadedFrameSource.h"
+
+// Generates a deterministic moving test pattern (scrolling colour gradients
+// plus a bouncing white block). Frame N always looks the same for a given
+// size and motion, so performance runs are reproducible without a camera.
+class SyntheticSource : public ThreadedFrameSource {
+public:
+    SyntheticSource(int width, int height, const SourceSettings& settings);
+    ~SyntheticSource() override;
+
+    bool isOpened() const override { return true; }
+
+    int getWidth() const override { return frameWidth; }
+    int getHeight() const override { return frameHeight; }
+    PixelFormat getPixelFormat() const override { return PixelFormat::BGR; }
+
+protected:
+    bool produce(Frame& frame) override;
+
+private:
+    int frameWidth;
+    int frameHeight;
+    float motion;
+    uint64_t frameNumber = 0;
+};
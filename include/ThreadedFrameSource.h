@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "FrameRecorder.h"
+#include "FrameRing.h"
+#include "FrameSource.h"
+#include "SceneChangeDetector.h"
+
+// Runs a producer thread that fills a lock-free FrameRing, so the render
+// loop never waits on capture or decode. Each frame is also checked for
+// changes on that thread, so the render loop can skip static ones cheaply.
+// Subclasses implement produce() and must call stop() in their destructor,
+// before their own members go away.
+class ThreadedFrameSource : public FrameSource {
+public:
+    ~ThreadedFrameSource() override;
+
+    bool isRunning() const override;
+    bool read(Frame& frame) override;
+    void setChangeTolerance(float tolerance) override;
+    void setRecorder(std::shared_ptr<FrameRecorder> recorder) override;
+    size_t getSlotBytes() const override;
+    void setSlotStorage(const std::vector<uint8_t*>& slots) override;
+
+    uint64_t getCapturedFrames() const override;
+    uint64_t getDroppedFrames() const override;
+    uint64_t getUnchangedFrames() const override;
+
+protected:
+    // Starts producing. A non-zero interval paces production to that period;
+    // otherwise produce() is expected to block until the next frame is due.
+    void start(std::chrono::nanoseconds frameInterval = std::chrono::nanoseconds::zero());
+    void stop();
+
+    // Allocates every ring slot up front so produce() can decode in place.
+    // Such slots may later be moved into external memory (setSlotStorage).
+    void preallocateSlots(int width, int height, int type);
+    // False if produce() swaps slot buffers rather than writing into them.
+    virtual bool keepsSlotBuffers() const { return true; }
+
+    // Fills `frame` with the next frame, reusing frame.image's buffer where
+    // possible. Returning false ends the source.
+    virtual bool produce(Frame& frame) = 0;
+    // Called before a slot is reused and on shutdown, for sources that lend
+    // out memory they own.
+    virtual void recycle(Frame& frame) {}
+    // Called from another thread to make a blocked produce() return soon.
+    virtual void interruptProducer() {}
+
+    bool stopRequested() const { return stopping.load(std::memory_order_relaxed); }
+
+private:
+    void producerLoop(std::chrono::nanoseconds frameInterval);
+    // Points the write slot at its external buffer, if it has one.
+    void bindSlotStorage(Frame& slot);
+
+    static_assert(FrameRing<Frame>::kSlotCount == kFrameSlots, "FrameSource::kFrameSlots must match the ring");
+    FrameRing<Frame> ring;
+    SceneChangeDetector sceneDetector; // Producer thread only
+    uint64_t contentGeneration = 0;    // Producer thread only
+    std::atomic<float> changeTolerance{0.0f};
+    std::mutex recorderMutex;
+    std::shared_ptr<FrameRecorder> recorder;
+    std::mutex slotStorageMutex;
+    std::vector<uint8_t*> slotStorage;
+    int slotWidth = 0;
+    int slotHeight = 0;
+    int slotType = -1; // -1 until preallocateSlots()
+    std::thread producerThread;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> capturedFrames{0};
+    std::atomic<uint64_t> droppedFrames{0};
+    std::atomic<uint64_t> unchangedFrames{0};
+};
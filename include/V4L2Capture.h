@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <linux/videodev2.h>
+
+#include "CaptureBackend.h"
+#include "Config.h"
+#include "MjpegDecoder.h"
+#include "V4L2Device.h"
+
+// Native V4L2 streaming capture over mmap'd driver buffers
+// (VIDIOC_REQBUFS/QBUF/DQBUF). Format, size and frame rate are chosen from
+// the modes the driver enumerates (see CameraModes.h). Frames are handed out
+// in the sensor's native format as cv::Mat headers over the driver buffer,
+// which stays dequeued until the frame is released; the renderer converts
+// to RGB on the GPU.
+//
+// MJPEG is the exception: a dequeue thread copies each compressed buffer
+// into an MjpegDecoder and requeues it at once, and grab() returns the
+// decoded frames in capture order.
+class V4L2Capture : public CaptureBackend {
+public:
+    V4L2Capture(const std::string& devicePath, const CameraSettings& settings);
+    ~V4L2Capture() override;
+
+    bool isOpened() const override;
+    bool grab(Frame& frame) override;
+    void release(Frame& frame) override;
+    bool fillsFrameStorage() const override;
+    bool swapsFrameStorage() const override;
+    void interrupt() override;
+    void setTargetResolution(int width, int height) override;
+
+    int getWidth() const override;
+    int getHeight() const override;
+    PixelFormat getPixelFormat() const override;
+
+private:
+    struct MappedBuffer {
+        void* start = nullptr;
+        size_t length = 0;
+    };
+
+    bool negotiateFormat(int width, int height, uint32_t fourcc);
+    void setFrameRate(double fps);
+    bool initBuffers(int bufferCount);
+    bool queueBuffer(uint32_t index);
+    bool dequeueBuffer(v4l2_buffer& buf);
+    void mjpegDequeueLoop();
+    void shutdown();
+
+    std::unique_ptr<V4L2Device> device;
+    std::vector<MappedBuffer> buffers;
+    uint32_t pixelFormat = 0;
+    uint32_t bytesPerLine = 0;
+    int frameWidth = 0;
+    int frameHeight = 0;
+    double frameRate = 0.0; // As confirmed by the driver, 0 if unknown
+    bool streaming = false;
+
+    std::unique_ptr<MjpegDecoder> mjpegDecoder;
+    std::thread mjpegDequeueThread;
+    std::atomic<bool> stopRequested{false};
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+// The handful of syscalls the native V4L2 backend needs, behind an interface
+// so the backend can run against a file-backed fake on machines without a
+// webcam. Methods mirror their POSIX counterparts: ioctl() returns -1 and sets
+// errno on failure, map() returns MAP_FAILED.
+class V4L2Device {
+public:
+    virtual ~V4L2Device() = default;
+
+    virtual bool isOpen() const = 0;
+    virtual int ioctl(unsigned long request, void* arg) = 0;
+    virtual void* map(size_t length, off_t offset) = 0;
+    virtual void unmap(void* address, size_t length) = 0;
+    // Waits until a buffer can be dequeued. Returns false on timeout or error.
+    virtual bool waitReadable(int timeoutMs) = 0;
+
+    // Opens a real device node such as "/dev/video0", or a fake device when
+    // the path has the form "fake:<file>". The fake streams raw frames from
+    // <file>, looping at the end, in whatever format the caller negotiates.
+    static std::unique_ptr<V4L2Device> open(const std::string& path);
+};
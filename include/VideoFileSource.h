@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include "Config.h"
+#include "ThreadedFrameSource.h"
+
+// Plays a video file through cv::VideoCapture, looping at the end.
+class VideoFileSource : public ThreadedFrameSource {
+public:
+    explicit VideoFileSource(const SourceSettings& settings);
+    ~VideoFileSource() override;
+
+    bool isOpened() const override;
+
+    int getWidth() const override;
+    int getHeight() const override;
+    PixelFormat getPixelFormat() const override { return PixelFormat::BGR; }
+
+protected:
+    bool produce(Frame& frame) override;
+
+private:
+    cv::VideoCapture cap;
+    int frameWidth = 0;
+    int frameHeight = 0;
+};
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+
+#include "Frame.h"
+#include "GpuProfiler.h"
+#include "Shader.h"
+
+// The camera frames on the GPU, one array layer per camera so a single draw
+// can composite all of them. Frames are uploaded in their capture format and
+// converted to RGB by sampleVideo() in shaders/include/video.glsl:
+//   BGR  -> one RGB8 texture
+//   YUYV -> one RGBA8 texture of half width, each texel holding Y0 Cb Y1 Cr
+//   NV12 -> an R8 luma texture plus an RG8 chroma texture at half resolution
+// Layers share one size, the largest frame seen; smaller frames fill the
+// top-left corner of their layer and getLayerScale() says how much of it.
+//
+// With upload buffers, frames are staged through a ring of pixel buffer
+// objects per layer and copied into the texture by the GPU. A fence per
+// buffer tells when the GPU is done with it, so the CPU only blocks if it
+// laps the GPU by the whole ring.
+//
+// Better still, a capture thread can write frames straight into a
+// persistently mapped buffer (mapCaptureSlots()); frames found there are
+// copied into the texture by the GPU with no CPU copy at all.
+//
+// Shaders that only need one colour per character cell read a separate,
+// tiny cell texture instead (sampleCell() in video.glsl), filled by
+// uploadCells() with each cell's average colour, or on the GPU from the
+// uploaded frame by reduceCells().
+class VideoTexture {
+public:
+    static constexpr GLenum kLumaUnit = GL_TEXTURE0;
+    static constexpr GLenum kChromaUnit = GL_TEXTURE3;
+    static constexpr GLenum kCellUnit = GL_TEXTURE4;
+    // Matches VIDEO_MAX_LAYERS in video.glsl.
+    static constexpr int kMaxLayers = 4;
+
+    // Time the CPU spent waiting for staging buffers to come free.
+    struct UploadStats {
+        uint64_t uploads = 0;
+        uint64_t zeroCopyUploads = 0; // Straight out of a capture slot
+        uint64_t fenceWaits = 0;
+        int64_t fenceWaitNs = 0;
+        int64_t maxFenceWaitNs = 0;
+    };
+
+    // uploadBuffers is the staging ring depth per layer; 0 uploads straight
+    // from client memory.
+    explicit VideoTexture(int layerCount = 1, int uploadBuffers = 0);
+    ~VideoTexture();
+
+    // Times the GL upload calls (GpuUpload) and reduceCells()
+    // (GpuCellGrid) on `profiler`, leaving out the CPU work around them.
+    void setProfiler(GpuProfiler* profiler) { this->profiler = profiler; }
+
+    // Uploads the frame into `layer`, reallocating storage if the format or
+    // the largest layer size changed. All layers must share one format.
+    void upload(const Frame& frame, int layer = 0);
+
+    // Character cells per layer for uploadCells(); every layer has the same
+    // grid. `extent` is the fractional grid the shaders index by: the cell
+    // texture holds ceil(extent) texels, and texel i averages the frame over
+    // [i, i + 1) / extent, so a partial last cell covers only what its
+    // character does. Shaders get the extent as videoCellExtent.
+    void setCellGrid(cv::Size2f extent);
+    cv::Size getCellGrid() const { return cellGrid; }
+    cv::Size2f getCellExtent() const { return cellExtent; }
+    // Averages the frame down to the cell grid on the CPU (see
+    // CellGridReducer) and uploads that into `layer` of the cell texture.
+    void uploadCells(const Frame& frame, int layer = 0);
+    // Fills `layer` of the cell texture from the frame already uploaded to
+    // that layer, running `program` (shaders/comp/cell_grid.comp).
+    void reduceCells(const Shader& program, int layer = 0) const;
+    void bind() const;
+
+    // Creates a persistently mapped buffer for `layer` holding slotCount
+    // regions of slotBytes each and returns their addresses, for a frame
+    // source to write frames into (FrameSource::setSlotStorage). Empty on
+    // failure. The memory stays mapped until the texture is destroyed.
+    std::vector<uint8_t*> mapCaptureSlots(int layer, int slotCount, size_t slotBytes);
+    // Blocks until the GPU has finished copying the last frame uploaded to
+    // `layer` out of its capture slot, so the source may overwrite it. Call
+    // before reading the layer's next frame.
+    void waitForCaptureSlot(int layer);
+
+    PixelFormat getFormat() const { return format; }
+    // Bumped whenever upload() reallocates the frame textures (a layer
+    // changed size or format), which leaves every layer empty until it is
+    // uploaded again.
+    uint64_t getStorageGeneration() const { return storageGeneration; }
+    int getLayerCount() const { return static_cast<int>(layerSizes.size()); }
+    // Fraction of the layer's storage covered by its latest frame.
+    cv::Point2f getLayerScale(int layer) const;
+
+    int getUploadBufferCount() const { return uploadBuffers; }
+    const UploadStats& getUploadStats() const { return uploadStats; }
+
+private:
+    struct StagingBuffer {
+        GLuint buffer = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+    };
+
+    struct CaptureBuffer {
+        GLuint buffer = 0;
+        uint8_t* mapped = nullptr;
+        size_t size = 0;
+        GLsync fence = nullptr; // After the last upload out of this buffer
+    };
+
+    void allocate(PixelFormat newFormat, int newWidth, int newHeight);
+    // Copies the image into the layer's next staging buffer and leaves it
+    // bound to GL_PIXEL_UNPACK_BUFFER. Returns nullptr (nothing bound) if
+    // staging is off or the buffer could not be mapped.
+    StagingBuffer* stage(const cv::Mat& image, int layer);
+    // Waits for `fence`, counting the time if it wasn't signalled yet, and
+    // deletes it.
+    void waitAndDelete(GLsync& fence);
+
+    GLuint planes[2] = {0, 0};
+    GLuint cellTexture = 0;
+    cv::Size cellGrid;
+    cv::Size2f cellExtent;
+    cv::Mat cellScratch;
+    PixelFormat format = PixelFormat::BGR;
+    int width = 0;
+    int height = 0;
+    uint64_t storageGeneration = 0;
+    std::vector<cv::Size> layerSizes;
+
+    int uploadBuffers = 0;
+    std::vector<StagingBuffer> stagingBuffers; // uploadBuffers per layer
+    std::vector<int> nextStagingBuffer;        // Per layer
+    std::vector<CaptureBuffer> captureBuffers; // Per layer
+    UploadStats uploadStats;
+    GpuProfiler* profiler = nullptr;
+};
@@ -0,0 +1,20 @@
+#version 460 core
+// Second stage of every cell effect: draws each cell's glyph from the font
+// atlas in the cell's colour. All per-cell decisions were made by the
+// compute pass, so this is one buffer read and one glyph lookup per pixel.
+#include "../include/cell.glsl"
+#include "../include/glyph.glsl"
+
+out vec4 FragColor;
+in vec2 TexCoord;
+
+
+void main()
+{
+    vec2 gridPos = TexCoord * (resolution / charSize);
+    ivec2 cell = min(ivec2(gridPos), cellGridSize - 1);
+    uvec2 entry = cellEntries[cellIndex(cell)];
+
+    float fontMask = sampleGlyph(float(entry.x), fract(gridPos), numChars);
+    FragColor = vec4(unpackUnorm4x8(entry.y).rgb * fontMask, 1.0);
+}
@@ -1,14 +1,11 @@
 #version 460 core
+#include "../include/frame.glsl"
+#include "../include/video.glsl"
+#include "../include/glyph.glsl"
 out vec4 FragColor;
 in vec2 TexCoord;
 
 // --- UNIFORMS ---
-uniform sampler2D videoTexture;
-uniform sampler2D fontAtlas;
-uniform vec2 resolution;
-uniform vec2 charSize;
-uniform float numChars;
-uniform float time;
 uniform float rain_speed = 0.3;
 uniform float tail_length = 0.25;
 uniform float sensitivity = 2.0; // NEW: Controls brightness reaction
@@ -52,16 +49,14 @@ void main()
 
     // 1. Sample the font character shape
     vec2 intraCharUV = fract(TexCoord * characterGrid);
-    float atlasX = (charIndex + intraCharUV.x) / numChars;
-    vec2 fontUV = vec2(atlasX, intraCharUV.y);
-    float fontMask = texture(fontAtlas, fontUV).r;
+    float fontMask = sampleGlyph(charIndex, intraCharUV, numChars);
 
     // 2. Get the camera feed color for this spot
     vec2 videoUV = (charCoord + 0.5) / characterGrid;
-    vec4 videoColor = texture(videoTexture, videoUV);
+    vec4 videoColor = sampleCell(videoUV);
 
-    // 3. Convert the camera color to a single brightness value (0.0 to 1.0)
-    float brightness = dot(videoColor.rgb, vec3(0.2126, 0.7152, 0.0722));
+    // 3. The cell's brightness (0.0 to 1.0), precomputed in alpha
+    float brightness = videoColor.a;
     float boostedBrightness = clamp(brightness * sensitivity, 0.0, 1.0);
 
     // 4. Create the final color
@@ -1,14 +1,11 @@
 #version 460 core
+#include "../include/frame.glsl"
+#include "../include/video.glsl"
+#include "../include/glyph.glsl"
 out vec4 FragColor;
 in vec2 TexCoord;
 
 // --- UNIFORMS ---
-uniform sampler2D videoTexture;
-uniform sampler2D fontAtlas;
-uniform vec2 resolution;
-uniform vec2 charSize;
-uniform float numChars;
-uniform float time;
 // --- MODIFIED ---
 uniform float rain_speed = 0.3;   // Now a uniform
 uniform float tail_length = 0.25; // Now a uniform
@@ -22,7 +19,7 @@ void main()
     vec2 characterGrid = resolution / charSize;
     vec2 charCoord = floor(TexCoord * characterGrid);
     vec2 videoUV = (charCoord + 0.5) / characterGrid;
-    vec4 videoColor = texture(videoTexture, videoUV);
+    vec4 videoColor = sampleCell(videoUV);
     vec3 baseColor = videoColor.rgb;
 
     float col_x = charCoord.x;
@@ -53,9 +50,7 @@ void main()
     float charIndex = floor(random(charCoord.xy + time_slice) * numChars);
 
     vec2 intraCharUV = fract(TexCoord * characterGrid);
-    float atlasX = (charIndex + intraCharUV.x) / numChars;
-    vec2 fontUV = vec2(atlasX, intraCharUV.y);
-    float fontMask = texture(fontAtlas, fontUV).r;
+    float fontMask = sampleGlyph(charIndex, intraCharUV, numChars);
 
     FragColor = vec4(rainColor * fontMask, 1.0);
 }
@@ -1,15 +1,12 @@
 #version 460 core
+#include "../include/frame.glsl"
+#include "../include/video.glsl"
+#include "../include/glyph.glsl"
 
 out vec4 FragColor;
 in vec2 TexCoord;
 
 // --- UNIFORMS ---
-uniform sampler2D videoTexture;
-uniform sampler2D fontAtlas;
-uniform vec2 resolution;
-uniform vec2 charSize;
-uniform float numChars;
-uniform float time;
 
 // --- CONFIGURABLE PARAMETERS ---
 uniform float rain_speed = 0.4;
@@ -69,16 +66,14 @@ void main()
 
     // --- STEP 5: Get camera feed brightness ---
     vec2 videoUV = (charCoord + 0.5) / characterGrid;
-    vec4 videoColor = texture(videoTexture, videoUV);
-    float brightness = dot(videoColor.rgb, vec3(0.2126, 0.7152, 0.0722));
+    vec4 videoColor = sampleCell(videoUV);
+    float brightness = videoColor.a;
     float boostedBrightness = clamp(brightness * sensitivity, 0.2, 1.0); // Keep a minimum brightness
 
     // --- STEP 6: Combine everything for the final color ---
     // Get the character shape from the font atlas
     vec2 intraCharUV = fract(TexCoord * characterGrid);
-    float atlasX = (charIndex + intraCharUV.x) / numChars;
-    vec2 fontUV = vec2(atlasX, intraCharUV.y);
-    float fontMask = texture(fontAtlas, fontUV).r;
+    float fontMask = sampleGlyph(charIndex, intraCharUV, numChars);
 
     // Final color is the calculated rain color, multiplied by the camera's brightness,
     // and then masked by the character's shape.
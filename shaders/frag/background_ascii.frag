@@ -1,16 +1,13 @@
 #version 460 core
+#include "../include/frame.glsl"
+#include "../include/video.glsl"
+#include "../include/mask.glsl"
+#include "../include/glyph.glsl"
 
 out vec4 FragColor;
 in vec2 TexCoord;
 
 // --- UNIFORMS (used by one or both effects) ---
-uniform sampler2D videoTexture; 
-uniform sampler2D fontAtlas;    
-uniform sampler2D maskTexture;  
-uniform vec2 resolution;
-uniform vec2 charSize;
-uniform float numChars;
-uniform float time;
 
 // --- CONFIGURABLE PARAMETERS ---
 uniform float rain_speed = 0.4;
@@ -33,8 +30,8 @@ void main()
     vec2 characterGrid = resolution / charSize;
     vec2 charCoord = floor(TexCoord * characterGrid);
     vec2 videoUV = (charCoord + 0.5) / characterGrid;
-    vec4 videoColorForCell = texture(videoTexture, videoUV);
-    float brightness = dot(videoColorForCell.rgb, vec3(0.2126, 0.7152, 0.0722));
+    vec4 videoColorForCell = sampleCell(videoUV);
+    float brightness = videoColorForCell.a;
 
 
     // --- STEP 1: Calculate the Background (Matrix digital rain effect) ---
@@ -64,9 +61,7 @@ void main()
         // Boost brightness based on video, get font mask
         float boostedBrightness = clamp(brightness * sensitivity, 0.2, 1.0); 
         vec2 intraCharUV = fract(TexCoord * characterGrid);
-        float atlasX = (charIndex + intraCharUV.x) / numChars;
-        vec2 fontUV = vec2(atlasX, intraCharUV.y);
-        float fontMask = texture(fontAtlas, fontUV).r;
+        float fontMask = sampleGlyph(charIndex, intraCharUV, numChars);
         
         matrixEffectColor = vec4(rainColor * boostedBrightness * fontMask, 1.0);
     }
@@ -82,17 +77,15 @@ void main()
 
         // Sample the character from the font atlas
         vec2 intraCharUV = fract(TexCoord * characterGrid);
-        float atlasX = (charIndex + intraCharUV.x) / numChars;
-        vec2 fontUV = vec2(atlasX, intraCharUV.y);
-        vec4 fontShape = texture(fontAtlas, fontUV);
+        float fontMask = sampleGlyph(charIndex, intraCharUV, numChars);
 
         // Final color is the character shape multiplied by the cell's original color
-        asciiEffectColor = fontShape * videoColorForCell;
+        asciiEffectColor = vec4(videoColorForCell.rgb * fontMask, 1.0);
     }
 
 
     // --- STEP 3: Get the mask value ---
-    float maskValue = texture(maskTexture, TexCoord).r;
+    float maskValue = sampleMask(TexCoord);
 
     // --- STEP 4: Mix the two effects using the mask ---
     // Background is matrix rain, Foreground is standard ASCII
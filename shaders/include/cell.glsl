@@ -0,0 +1,16 @@
+// The cell buffer shared by the two stages of a cell effect: a compute
+// pass (shaders/cell/*.comp, see cell_pass.glsl) writes one entry per
+// character cell, and shaders/cell/expand.frag draws each entry's glyph.
+
+#include "frame.glsl"
+
+uniform ivec2 cellGridSize; // Whole and partial cells across and down
+
+// x: glyph index into the font atlas; y: colour, packUnorm4x8()
+layout(std430, binding = 0) buffer CellBuffer {
+    uvec2 cellEntries[];
+};
+
+int cellIndex(ivec2 cell) {
+    return cell.y * cellGridSize.x + cell.x;
+}
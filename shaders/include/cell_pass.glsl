@@ -0,0 +1,27 @@
+// Compute stage of a cell effect. An effect in shaders/cell/ includes this
+// and defines shadeCell(), which runs once per character cell instead of
+// once per pixel; expand.frag then stamps the chosen glyph in the chosen
+// colour. Pull it in with: #include "../include/cell_pass.glsl"
+
+#include "video.glsl"
+#include "cell.glsl"
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+struct Cell {
+    float glyph;  // Index into the font atlas, 0 to numChars - 1
+    vec3 color;   // Colour the glyph is drawn in
+};
+
+// charCoord is the cell's column and row, characterGrid the cells across
+// and down (fractional when the output is not a whole number of cells).
+Cell shadeCell(vec2 charCoord, vec2 characterGrid);
+
+void main() {
+    ivec2 cell = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(cell, cellGridSize))) {
+        return;
+    }
+    Cell result = shadeCell(vec2(cell), resolution / charSize);
+    cellEntries[cellIndex(cell)] = uvec2(uint(max(result.glyph, 0.0)), packUnorm4x8(vec4(result.color, 1.0)));
+}
@@ -0,0 +1,13 @@
+// Per-frame constants shared by every program, written once per frame into
+// one uniform buffer (FrameConstants in include/FrameConstants.h, which
+// must keep the same std140 layout).
+// Pull it in with: #include "../include/frame.glsl"
+
+layout(std140, binding = 0) uniform FrameConstants {
+    vec2 resolution;     // Size of the render target (updateRenderTarget()); the character grid spans it
+    vec2 charSize;       // Size of one character cell in those pixels
+    float time;          // Seconds since startup
+    float numChars;      // Glyphs in the font atlas
+    int frameIndex;      // Frames drawn so far
+    int maskFrameIndex;  // Frame that last refreshed maskTexture
+};
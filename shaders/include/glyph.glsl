@@ -0,0 +1,33 @@
+// Glyph lookup shared by the ASCII effects.
+// Pull it in with: #include "../include/glyph.glsl"
+//
+// Glyphs normally come from a filtered fetch of the font atlas. With
+// GLYPH_BITS defined they come from one-bit masks packed by GlyphBits into
+// a storage buffer instead: a few bytes per glyph that stay in cache, and
+// no texture bandwidth at high output resolutions.
+
+#include "frame.glsl"
+
+layout(binding = 1) uniform sampler2D fontAtlas; // The font atlas image
+#ifdef GLYPH_BITS
+layout(std430, binding = 1) readonly buffer GlyphBitBuffer {
+    uint glyphWords[];
+};
+#endif
+
+// Ink coverage of glyph number `glyph` at intraCharUV, which runs 0..1
+// across the character cell.
+float sampleGlyph(float glyph, vec2 intraCharUV, float numChars) {
+#ifdef GLYPH_BITS
+    // Packed glyphs are charSize pixels, as in the atlas.
+    ivec2 glyphSize = ivec2(charSize);
+    ivec2 pixel = clamp(ivec2(intraCharUV * vec2(glyphSize)), ivec2(0), glyphSize - 1);
+    int bit = pixel.y * glyphSize.x + pixel.x;
+    int wordsPerGlyph = (glyphSize.x * glyphSize.y + 31) / 32;
+    int word = min(int(glyph) * wordsPerGlyph + bit / 32, glyphWords.length() - 1);
+    return float((glyphWords[word] >> uint(bit & 31)) & 1u);
+#else
+    vec2 fontUV = vec2((glyph + intraCharUV.x) / numChars, intraCharUV.y);
+    return texture(fontAtlas, fontUV).r;
+#endif
+}
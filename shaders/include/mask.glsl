@@ -0,0 +1,32 @@
+// Shared segmentation mask sampling for shaders/frag/*.frag.
+// Pull it in with: #include "../include/mask.glsl"
+//
+// maskTexture holds the model's raw logits at its own resolution (256x144
+// for the selfie segmenter). Bilinear filtering upsamples the logits, and
+// sampleMask() turns them into coverage, so the CPU never resizes or
+// thresholds anything. Declaring maskTexture is what enables the model.
+
+#include "video.glsl"
+
+layout(binding = 2) uniform sampler2D maskTexture; // R16F logits of the first camera
+uniform float maskThreshold = 0.5;  // Foreground probability cut-off
+uniform float maskSoftness = 0.0;   // Half-width of the soft edge around the threshold; 0 is a hard edge
+
+// Person coverage in [0, 1], with uv covering the whole output. The mask
+// follows the first camera, so in a grid it only covers that camera's tile.
+float sampleMask(vec2 uv) {
+    if (videoLayerCount > 1 && videoLayout == VIDEO_LAYOUT_GRID) {
+        vec2 cell = floor(uv * vec2(videoGrid));
+        if (cell != vec2(0.0)) {
+            return 0.0;
+        }
+        uv = uv * vec2(videoGrid) - cell;
+    }
+
+    float logit = texture(maskTexture, uv).r;
+    float probability = 1.0 / (1.0 + exp(-logit));
+    if (maskSoftness <= 0.0) {
+        return step(maskThreshold, probability);
+    }
+    return smoothstep(maskThreshold - maskSoftness, maskThreshold + maskSoftness, probability);
+}
@@ -0,0 +1,142 @@
+// Shared camera sampling for shaders/frag/*.frag.
+// Pull it in with: #include "../include/video.glsl"
+//
+// Frames arrive in the camera's native format (see VideoTexture) and are
+// converted to RGB here, so effects just call sampleVideo(uv). With several
+// cameras each one is a layer of the texture arrays, and sampleVideo() also
+// does the compositing: a grid of tiles, or all cameras blended on top of
+// each other.
+//
+// Effects that draw one character per cell should call sampleCell(uv)
+// instead: it returns the cell's average colour with its luma in alpha,
+// prepared once per cell (videoCellTexture) by the CPU or by
+// shaders/comp/cell_grid.comp. That is switched on by defining
+// VIDEO_CELLS; without it sampleCell() falls back to sampleVideo().
+
+const int VIDEO_MAX_LAYERS = 4;
+
+// Texture units are fixed here (VideoTexture::k*Unit), so nothing has to
+// assign them per program.
+layout(binding = 0) uniform sampler2DArray videoTexture;       // RGB frame, packed YUYV, or NV12 luma
+layout(binding = 3) uniform sampler2DArray videoChromaTexture; // NV12 interleaved CbCr plane
+#ifdef VIDEO_CELLS
+layout(binding = 4) uniform sampler2DArray videoCellTexture;   // One RGB + luma texel per character cell
+// Fractional cells per layer; the texture holds ceil(videoCellExtent) texels.
+uniform vec2 videoCellExtent = vec2(1.0);
+#endif
+uniform int videoFormat = 0;               // One of the VIDEO_FORMAT_* constants below
+
+uniform int videoLayerCount = 1;
+uniform int videoLayout = 0;               // One of the VIDEO_LAYOUT_* constants below
+uniform ivec2 videoGrid = ivec2(1, 1);     // Columns and rows for VIDEO_LAYOUT_GRID
+// Part of each layer covered by its latest frame (smaller cameras, reduced-scale decode)
+uniform vec2 videoLayerScale[VIDEO_MAX_LAYERS] = vec2[](vec2(1.0), vec2(1.0), vec2(1.0), vec2(1.0));
+// Blend weights for VIDEO_LAYOUT_LAYERED, normalized here
+uniform float videoLayerWeight[VIDEO_MAX_LAYERS] = float[](1.0, 1.0, 1.0, 1.0);
+
+const int VIDEO_FORMAT_RGB  = 0;
+const int VIDEO_FORMAT_YUYV = 1;
+const int VIDEO_FORMAT_NV12 = 2;
+
+const int VIDEO_LAYOUT_GRID    = 0;
+const int VIDEO_LAYOUT_LAYERED = 1;
+
+// Rec. 709 weights the effects pick characters by.
+const vec3 VIDEO_LUMA = vec3(0.2126, 0.7152, 0.0722);
+
+// BT.601 limited range, which is what UVC webcams deliver.
+vec3 yuvToRgb(float y, float cb, float cr) {
+    y = (y - 16.0 / 255.0) * 1.164;
+    cb -= 0.5;
+    cr -= 0.5;
+    return clamp(vec3(y + 1.596 * cr,
+                      y - 0.392 * cb - 0.813 * cr,
+                      y + 2.017 * cb), 0.0, 1.0);
+}
+
+// Pixels in the layer's latest frame.
+ivec2 videoFrameSize(int layer) {
+    ivec2 texels = ivec2(vec2(textureSize(videoTexture, 0).xy) * videoLayerScale[layer] + 0.5);
+    // Packed YUYV texels hold two pixels each.
+    return videoFormat == VIDEO_FORMAT_YUYV ? texels * ivec2(2, 1) : texels;
+}
+
+// One camera, with uv covering its whole frame.
+vec4 sampleVideoLayer(vec2 uv, int layer) {
+    vec2 scale = videoLayerScale[layer];
+    if (videoFormat == VIDEO_FORMAT_YUYV) {
+        // Each texel packs two pixels as (Y0, Cb, Y1, Cr).
+        ivec2 frameSize = videoFrameSize(layer);
+        ivec2 pixel = clamp(ivec2(uv * vec2(frameSize)), ivec2(0), frameSize - 1);
+        vec4 texel = texelFetch(videoTexture, ivec3(pixel.x / 2, pixel.y, layer), 0);
+        float y = (pixel.x & 1) == 0 ? texel.r : texel.b;
+        return vec4(yuvToRgb(y, texel.g, texel.a), 1.0);
+    }
+
+    // Keep the filter footprint inside the frame when it only covers part of the layer.
+    vec2 halfTexel = 0.5 / vec2(textureSize(videoTexture, 0).xy);
+    vec2 layerUV = clamp(uv * scale, halfTexel, scale - halfTexel);
+    if (videoFormat == VIDEO_FORMAT_NV12) {
+        float y = texture(videoTexture, vec3(layerUV, layer)).r;
+        vec2 cbcr = texture(videoChromaTexture, vec3(layerUV, layer)).rg;
+        return vec4(yuvToRgb(y, cbcr.r, cbcr.g), 1.0);
+    }
+    return texture(videoTexture, vec3(layerUV, layer));
+}
+
+// One camera's cell colours; every layer's grid covers its whole frame.
+vec4 sampleCellLayer(vec2 uv, int layer) {
+#ifdef VIDEO_CELLS
+    // Texel i covers [i, i + 1) / videoCellExtent of the layer, the same
+    // span as character i of a grid of that many cells.
+    ivec2 cells = textureSize(videoCellTexture, 0).xy;
+    ivec2 cell = clamp(ivec2(floor(uv * videoCellExtent)), ivec2(0), cells - 1);
+    return texelFetch(videoCellTexture, ivec3(cell, layer), 0);
+#else
+    return sampleVideoLayer(uv, layer);
+#endif
+}
+
+vec4 sampleLayer(vec2 uv, int layer, bool cells) {
+    return cells ? sampleCellLayer(uv, layer) : sampleVideoLayer(uv, layer);
+}
+
+// Grid or layered compositing of sampleLayer(), with uv covering the whole output.
+vec4 compositeVideo(vec2 uv, bool cells) {
+    if (videoLayerCount <= 1) {
+        return sampleLayer(uv, 0, cells);
+    }
+
+    if (videoLayout == VIDEO_LAYOUT_LAYERED) {
+        vec4 color = vec4(0.0);
+        float totalWeight = 0.0;
+        for (int layer = 0; layer < videoLayerCount; ++layer) {
+            color += sampleLayer(uv, layer, cells) * videoLayerWeight[layer];
+            totalWeight += videoLayerWeight[layer];
+        }
+        return totalWeight > 0.0 ? color / totalWeight : vec4(0.0, 0.0, 0.0, cells ? 0.0 : 1.0);
+    }
+
+    vec2 cell = floor(uv * vec2(videoGrid));
+    int layer = int(cell.y) * videoGrid.x + int(cell.x);
+    if (layer >= videoLayerCount) {
+        return vec4(0.0, 0.0, 0.0, cells ? 0.0 : 1.0);
+    }
+    return sampleLayer(uv * vec2(videoGrid) - cell, layer, cells);
+}
+
+// The composited picture, with uv covering the whole output.
+vec4 sampleVideo(vec2 uv) {
+    return compositeVideo(uv, false);
+}
+
+// The average colour of the character cell around uv in rgb, and its luma
+// in alpha. Pass the cell centre, as the ASCII effects already do.
+vec4 sampleCell(vec2 uv) {
+#ifdef VIDEO_CELLS
+    return compositeVideo(uv, true);
+#else
+    vec3 color = sampleVideo(uv).rgb;
+    return vec4(color, dot(color, VIDEO_LUMA));
+#endif
+}
@@ -1,4 +1,7 @@
 #include "Application.h"
+#include "CameraModes.h"
+#include "FrameRecorder.h"
+#include "GlyphBits.h"
 #include <iostream>
 #include <stdexcept>
 #include <opencv2/imgcodecs.hpp>
@@ -6,8 +9,31 @@
 #include <algorithm>
 #include <iterator>
 #include <filesystem>
+#include <cmath>
+#include <random>
 
 namespace {
+const char* const kLayerScaleNames[VideoTexture::kMaxLayers] = {
+    "videoLayerScale[0]", "videoLayerScale[1]", "videoLayerScale[2]", "videoLayerScale[3]"
+};
+const char* const kLayerWeightNames[VideoTexture::kMaxLayers] = {
+    "videoLayerWeight[0]", "videoLayerWeight[1]", "videoLayerWeight[2]", "videoLayerWeight[3]"
+};
+
+// Latest modification time among `files`; a missing file (an editor
+// halfway through saving) counts as unchanged.
+std::filesystem::file_time_type newestWriteTime(const std::vector<std::filesystem::path>& files) {
+    std::filesystem::file_time_type newest = std::filesystem::file_time_type::min();
+    for (const auto& file : files) {
+        std::error_code error;
+        const auto written = std::filesystem::last_write_time(file, error);
+        if (!error) {
+            newest = std::max(newest, written);
+        }
+    }
+    return newest;
+}
+
 // Helper function for loading textures
 void loadTextureFromFile(const char* path, GLuint& textureID, GLenum textureUnit) {
     glGenTextures(1, &textureID);
@@ -49,6 +75,15 @@ Application::~Application() {
 }
 
 int Application::run() {
+    if (config.listModes) {
+        for (const CameraSettings& camera : camera_settings_list(config)) {
+            printCameraModes(camera);
+        }
+        return 0;
+    }
+    if (config.glyphBenchmark) {
+        return runGlyphBenchmark();
+    }
     try {
         init();
         mainLoop();
@@ -60,9 +95,11 @@ int Application::run() {
 }
 
 void Application::init() {
-    if (!initCamera()) throw std::runtime_error("Camera initialization failed");
+    if (!initFrameSource()) throw std::runtime_error("Frame source initialization failed");
+    latencyTracker = std::make_unique<LatencyTracker>(config.stats);
     if (!initWindow()) throw std::runtime_error("Window initialization failed");
     if (!initGLAD()) throw std::runtime_error("GLAD initialization failed");
+    gpuProfiler = std::make_unique<GpuProfiler>(*latencyTracker, config.stats.gpuTimers);
     
     segmentationModel = std::make_unique<fs::SegmentationModel>("models/selfie_segmenter_landscape.onnx");
     if (!segmentationModel->init()) {
@@ -72,6 +109,7 @@ void Application::init() {
     initShader();
     initFonts();
     initGeometry();
+    initFrameConstants();
     initTextures();
 
     if (!shaders.empty()) {
@@ -80,14 +118,33 @@ void Application::init() {
 }
 
 void Application::mainLoop() {
-    cv::Mat frame;
-    if (!camera->read(frame)) {
-        throw std::runtime_error("Could not read the first frame from the camera.");
+    const size_t sourceCount = frameSources.size();
+    std::vector<Frame> frames(sourceCount);
+    std::vector<FrameTimeline> timelines(sourceCount);
+    cv::Mat segmentationInput;
+    for (size_t i = 0; i < sourceCount; ++i) {
+        if (!frameSources[i]->waitForFrame(frames[i])) {
+            throw std::runtime_error("Could not read the first frame from frame source " + std::to_string(i) + ".");
+        }
+        timelines[i] = FrameTimeline::begin(frames[i], static_cast<int>(i));
     }
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, videoTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, frame.cols, frame.rows, 0, GL_BGR, GL_UNSIGNED_BYTE, frame.data);
 
+    // Every source captures on its own thread, so only upload (and segment)
+    // a layer when its source has published a newer frame than the one
+    // already on the GPU, and only if that frame actually shows something
+    // new (its contentGeneration moved). Whole frames and cell colours are
+    // tracked separately and only kept current while the shader reads them
+    // (the GPU cell pass reads the frame too); either is caught up after a
+    // shader switch. Reallocating the frame textures (one layer changed
+    // size, e.g. with reduced-scale decode) empties every layer, so all of
+    // them are uploaded again, static or stopped. Each new frame's timeline
+    // is completed by the first swap that shows it.
+    std::vector<bool> hasNewFrame(sourceCount, true);
+    std::vector<uint64_t> uploadedGeneration(sourceCount, 0);
+    std::vector<uint64_t> cellGeneration(sourceCount, 0);
+    cv::Size cellGrid = videoTexture->getCellGrid();
+    uint64_t maskGeneration = 0;
+    int64_t workStartNs = steadyClockNs();
     while (!glfwWindowShouldClose(window)) {
         if (!configFilePath.empty() && std::filesystem::exists(configFilePath)) {
             auto currentWriteTime = std::filesystem::last_write_time(configFilePath);
@@ -96,50 +153,286 @@ void Application::mainLoop() {
                 lastConfigWriteTime = currentWriteTime;
             }
         }
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, videoTexture);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame.cols, frame.rows, GL_BGR, GL_UNSIGNED_BYTE, frame.data);
+        if (cellGrid != videoTexture->getCellGrid()) {
+            cellGrid = videoTexture->getCellGrid();
+            std::fill(cellGeneration.begin(), cellGeneration.end(), 0);
+        }
+        gpuProfiler->beginFrame(shaderNames[currentShaderIndex]);
+        bool layersWiped = false;
+        for (size_t i = 0; i < sourceCount; ++i) {
+            const uint64_t generation = frames[i].contentGeneration;
+            const bool needsFrame = currentShaderUsesFrames || (currentShaderUsesCells && cellGridProgram);
+            const bool framesStale = needsFrame && uploadedGeneration[i] != generation;
+            const bool cellsStale = currentShaderUsesCells && cellGeneration[i] != generation;
+            if (!framesStale && !cellsStale) {
+                if (hasNewFrame[i]) {
+                    latencyTracker->recordSkip(LatencyTracker::Upload);
+                }
+                continue;
+            }
+            if (framesStale) {
+                const uint64_t storage = videoTexture->getStorageGeneration();
+                videoTexture->upload(frames[i], static_cast<int>(i));
+                if (videoTexture->getStorageGeneration() != storage) {
+                    // Reallocating the array wiped the other layers too, static or not.
+                    std::fill(uploadedGeneration.begin(), uploadedGeneration.end(), 0);
+                    layersWiped = true;
+                }
+                uploadedGeneration[i] = generation;
+            }
+            if (cellsStale && cellGridProgram) {
+                videoTexture->reduceCells(*cellGridProgram, static_cast<int>(i));
+                cellGeneration[i] = generation;
+            } else if (cellsStale) {
+                videoTexture->uploadCells(frames[i], static_cast<int>(i));
+                cellGeneration[i] = generation;
+            }
+            timelines[i].uploadNs = steadyClockNs();
+        }
+        // Layers before the one that reallocated were wiped after their upload.
+        for (size_t i = 0; layersWiped && i < sourceCount; ++i) {
+            if (uploadedGeneration[i] != frames[i].contentGeneration) {
+                videoTexture->upload(frames[i], static_cast<int>(i));
+                uploadedGeneration[i] = frames[i].contentGeneration;
+            }
+        }
 
-        if (currentShaderUsesMask) {
-        cv::Mat mask = segmentationModel->infer(frame);
-        glActiveTexture(GL_TEXTURE2); // Use texture unit 2 for the mask
-        glBindTexture(GL_TEXTURE_2D, maskTexture);
-        // We use GL_RED since the mask is single-channel
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mask.cols, mask.rows, GL_RED, GL_UNSIGNED_BYTE, mask.data);
-    }
+        // The segmentation mask follows the first camera. It is also brought
+        // up to date when switching to a mask shader over a static scene.
+        const bool maskIsStale = maskGeneration != frames[0].contentGeneration;
+        if (hasNewFrame[0] && currentShaderUsesMask && !maskIsStale) {
+            latencyTracker->recordSkip(LatencyTracker::Inference);
+        }
+        if (currentShaderUsesMask && maskIsStale) {
+            maskGeneration = frames[0].contentGeneration;
+            const Frame& frame = frames[0];
+            FrameTimeline& timeline = timelines[0];
+            timeline.inferenceStartNs = steadyClockNs();
+            cv::Mat logits = segmentationModel->infer(frame.toBGR(segmentationInput));
+            timeline.inferenceEndNs = steadyClockNs();
+            // Raw logits at model resolution; sampleMask() in mask.glsl
+            // upsamples and thresholds them on the GPU.
+            gpuProfiler->begin(LatencyTracker::GpuMask);
+            glActiveTexture(GL_TEXTURE2); // Use texture unit 2 for the mask
+            glBindTexture(GL_TEXTURE_2D, maskTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, logits.cols, logits.rows, GL_RED, GL_FLOAT, logits.data);
+            gpuProfiler->end(LatencyTracker::GpuMask);
+            frameConstants.maskFrameIndex = frameConstants.frameIndex;
+        }
 
+        renderTarget->bind();
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         
+        frameConstants.time = static_cast<float>(glfwGetTime());
+        writeFrameConstants();
+        ++frameConstants.frameIndex;
+
         Shader* currentShader = shaders[currentShaderIndex].get();
         currentShader->use();
-        currentShader->setFloat("time", (float)glfwGetTime());
+        updateVideoLayerScales(*currentShader);
+        if (shaderIsCellPass[currentShaderIndex]) {
+            // Shade every cell once, then let the expansion shader draw the glyphs.
+            gpuProfiler->begin(LatencyTracker::GpuCells);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellBuffer);
+            glDispatchCompute((cellPassGrid.width + 7) / 8, (cellPassGrid.height + 7) / 8, 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            gpuProfiler->end(LatencyTracker::GpuCells);
+            glyphExpandShader->use();
+        }
         
+        gpuProfiler->begin(LatencyTracker::GpuDraw);
         glBindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        gpuProfiler->end(LatencyTracker::GpuDraw);
+        cv::Size windowSize;
+        glfwGetFramebufferSize(window, &windowSize.width, &windowSize.height);
+        gpuProfiler->begin(LatencyTracker::GpuBlit);
+        renderTarget->blitToWindow(windowSize, upscale);
+        gpuProfiler->end(LatencyTracker::GpuBlit);
+        const int64_t drawSubmitNs = steadyClockNs();
+        framePacer->recordWork(workStartNs, drawSubmitNs);
         
         glfwSwapBuffers(window);
+        const int64_t swapNs = steadyClockNs();
+        latencyTracker->recordPresent(swapNs);
+        for (size_t i = 0; i < sourceCount; ++i) {
+            if (hasNewFrame[i]) {
+                timelines[i].drawSubmitNs = drawSubmitNs;
+                timelines[i].swapNs = swapNs;
+                latencyTracker->record(timelines[i]);
+            }
+        }
+        pumpShaderCompiles();
+        pollShaderReloads();
         glfwPollEvents();
+
+        // Frames are read only after the pacing wait, so a cap or
+        // low-latency mode draws the newest frame rather than a stale one.
+        framePacer->waitForNextFrame(swapNs);
+        workStartNs = steadyClockNs();
         
-        if (!camera->read(frame)) {
-            break;  
+        // Keep showing the last frame of a camera that stops; quit once all have.
+        bool anyRunning = false;
+        for (size_t i = 0; i < sourceCount; ++i) {
+            // read() hands the current frame's slot back to the source.
+            videoTexture->waitForCaptureSlot(static_cast<int>(i));
+            hasNewFrame[i] = frameSources[i]->read(frames[i]);
+            if (hasNewFrame[i]) {
+                timelines[i] = FrameTimeline::begin(frames[i], static_cast<int>(i));
+            }
+            anyRunning = anyRunning || hasNewFrame[i] || frameSources[i]->isRunning();
+        }
+        if (!anyRunning) {
+            break;
         }
     }
 }
 
 void Application::cleanup() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glDeleteTextures(1, &videoTexture);
-    glDeleteTextures(1, &fontTexture);
-    glDeleteTextures(1, &maskTexture); // NEW: Cleanup mask texture
+    // Capture threads may be writing into buffers videoTexture has mapped.
+    frameSources.clear();
+    if (gpuProfiler && gpuProfiler->getDroppedResults() > 0) {
+        std::cout << "GPU timer results dropped: " << gpuProfiler->getDroppedResults() << std::endl;
+    }
+    gpuProfiler.reset();
+    latencyTracker.reset();
+    // Without a window there is no GL context (e.g. --list-modes).
     if (window) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+        glDeleteBuffers(1, &cellBuffer);
+        glDeleteBuffers(1, &glyphBuffer);
+        glDeleteBuffers(1, &frameConstantsBuffer);
+        printUploadStats();
+        videoTexture.reset();
+        renderTarget.reset();
+        glDeleteTextures(1, &fontTexture);
+        glDeleteTextures(1, &maskTexture); // NEW: Cleanup mask texture
         glfwDestroyWindow(window);
     }
     glfwTerminate();
 }
 
+// Draws a screen of random glyphs into a 4K offscreen target with the
+// shared expansion shader, once through the atlas and once through the
+// bit-packed masks, and prints the GPU time per frame of each. Needs no
+// camera; the font is the configured one.
+int Application::runGlyphBenchmark() {
+    constexpr int kWidth = 3840;
+    constexpr int kHeight = 2160;
+    constexpr int kWarmupFrames = 20;
+    constexpr int kFrames = 300;
+
+    if (!glfwInit()) return -1;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(64, 64, "Glyph benchmark", NULL, NULL);
+    if (!window) {
+        std::cerr << "ERROR: Could not create an OpenGL 4.6 context for the benchmark." << std::endl;
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!initGLAD()) return -1;
+
+    try {
+        initFonts();
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return -1;
+    }
+    initGeometry();
+    const FontProfile& font = getCurrentFontProfile();
+    loadTextureFromFile(font.path.c_str(), fontTexture, GL_TEXTURE1);
+    const bool glyphBitsSetting = config.render.glyphBits;
+    config.render.glyphBits = true;
+    uploadGlyphBits();
+    config.render.glyphBits = glyphBitsSetting;
+
+    // Random glyphs in random colours, so neither path benefits from
+    // every cell hitting the same cache lines.
+    const cv::Size grid(static_cast<int>(std::ceil(kWidth / font.charWidth)),
+                        static_cast<int>(std::ceil(kHeight / font.charHeight)));
+    const int numChars = std::max(1, static_cast<int>(font.numChars));
+    std::mt19937 rng(12345);
+    std::vector<GLuint> entries(static_cast<size_t>(grid.area()) * 2);
+    for (size_t i = 0; i < entries.size(); i += 2) {
+        entries[i] = static_cast<GLuint>(rng() % numChars);
+        entries[i + 1] = static_cast<GLuint>(rng()) | 0xff000000u;
+    }
+    glGenBuffers(1, &cellBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(entries.size() * sizeof(GLuint)), entries.data(),
+                 GL_STATIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellBuffer);
+
+    GLuint framebuffer = 0;
+    GLuint colorBuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, kWidth, kHeight);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glViewport(0, 0, kWidth, kHeight);
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    initFrameConstants();
+    frameConstants.resolution[0] = static_cast<float>(kWidth);
+    frameConstants.resolution[1] = static_cast<float>(kHeight);
+    frameConstants.charSize[0] = font.charWidth;
+    frameConstants.charSize[1] = font.charHeight;
+    frameConstants.numChars = font.numChars;
+    writeFrameConstants();
+
+    std::cout << "Glyph benchmark: " << sortedFontNames[currentFontIndex] << ", " << grid.width << "x" << grid.height
+              << " cells at " << kWidth << "x" << kHeight << ", " << kFrames << " frames" << std::endl;
+    for (bool bits : {false, true}) {
+        Shader expand("shaders/vert/shader.vert", "shaders/cell/expand.frag", bits ? "#define GLYPH_BITS 1\n" : "");
+        if (!expand.isLinked()) {
+            std::cerr << "ERROR: Could not build the " << (bits ? "bit-packed" : "atlas") << " glyph shader." << std::endl;
+            continue;
+        }
+        expand.use();
+        expand.setIVec2("cellGridSize", grid.width, grid.height);
+        glBindVertexArray(VAO);
+        for (int i = 0; i < kWarmupFrames; ++i) {
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        }
+        glFinish();
+
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        for (int i = 0; i < kFrames; ++i) {
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        std::cout << "  " << (bits ? "bit-packed" : "atlas     ") << ": " << elapsedNs / 1e6 / kFrames
+                  << " ms per frame" << std::endl;
+    }
+
+    glDeleteQueries(1, &query);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteFramebuffers(1, &framebuffer);
+    return 0;
+}
+
+void Application::printUploadStats() const {
+    if (!videoTexture) {
+        return;
+    }
+    const VideoTexture::UploadStats& stats = videoTexture->getUploadStats();
+    std::cout << "Video uploads: " << stats.uploads << " (" << stats.zeroCopyUploads << " straight from capture buffers), "
+              << videoTexture->getUploadBufferCount() << " staging buffers per layer; CPU waited on a fence "
+              << stats.fenceWaits << " times, "
+              << stats.fenceWaitNs / 1e6 << " ms total (max " << stats.maxFenceWaitNs / 1e6 << " ms)." << std::endl;
+}
+
 bool Application::loadConfig(int argc, char* argv[]) {
     config = load_configuration(argc, argv);
 
@@ -154,9 +447,31 @@ bool Application::loadConfig(int argc, char* argv[]) {
     return true;
 }
 
-bool Application::initCamera() {
-    camera = std::make_unique<Camera>(config.cameraDeviceID, config.cameraWidth, config.cameraHeight);
-    return camera->isOpened();
+bool Application::initFrameSource() {
+    frameSources = FrameSource::createAll(config, VideoTexture::kMaxLayers);
+    for (size_t i = 0; i < frameSources.size(); ++i) {
+        frameSources[i]->setChangeTolerance(config.source.staticTolerance);
+        if (!frameSources[i]->isOpened()) {
+            std::cerr << "ERROR: Frame source " << i << " could not be opened." << std::endl;
+            return false;
+        }
+        // The cameras share one texture array, which has a single pixel format.
+        if (frameSources[i]->getPixelFormat() != frameSources[0]->getPixelFormat()) {
+            std::cerr << "ERROR: Camera " << i << " delivers a different pixel format than camera 0. "
+                      << "Use the same backend and format for every camera." << std::endl;
+            return false;
+        }
+    }
+    if (!config.source.recordPath.empty()) {
+        // The source keeps the recorder alive; it finishes the file when the
+        // source goes away.
+        auto recorder = std::make_shared<FrameRecorder>();
+        if (!recorder->open(config.source.recordPath)) {
+            return false;
+        }
+        frameSources[0]->setRecorder(recorder);
+    }
+    return true;
 }
 
 bool Application::initWindow() {
@@ -165,7 +480,7 @@ bool Application::initWindow() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     
-    window = glfwCreateWindow(camera->getWidth(), camera->getHeight(), "ASCII Shader", NULL, NULL);
+    window = glfwCreateWindow(frameSources[0]->getWidth(), frameSources[0]->getHeight(), "ASCII Shader", NULL, NULL);
     if (!window) {
         glfwTerminate();
         return false;
@@ -174,9 +489,45 @@ bool Application::initWindow() {
     glfwSetWindowUserPointer(window, this);
     glfwSetKeyCallback(window, key_callback);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    initPacing();
     return true;
 }
 
+// Sets the swap interval explicitly rather than leaving it to the driver,
+// and sets up the frame cap and low-latency pacing on top of it.
+void Application::initPacing() {
+    const std::string& vsync = config.pacing.vsync;
+    int swapInterval = 1;
+    if (vsync == "off") {
+        swapInterval = 0;
+    } else if (vsync == "adaptive") {
+        if (glfwExtensionSupported("GLX_EXT_swap_control_tear") || glfwExtensionSupported("WGL_EXT_swap_control_tear")) {
+            swapInterval = -1;
+        } else {
+            std::cerr << "Warning: Adaptive vsync is not supported here. Using vsync on." << std::endl;
+        }
+    } else if (vsync != "on") {
+        std::cerr << "Warning: Unknown vsync '" << vsync << "'. Using on." << std::endl;
+    }
+    glfwSwapInterval(swapInterval);
+
+    GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode* mode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+    const double refreshHz = mode ? mode->refreshRate : 0.0;
+    framePacer = std::make_unique<FramePacer>(config.pacing.maxFps, config.pacing.lowLatency, refreshHz);
+    if (config.pacing.lowLatency && !framePacer->isActive()) {
+        std::cerr << "Warning: Low-latency mode needs max_fps or a known refresh rate. It is off." << std::endl;
+    }
+    std::cout << "Pacing: vsync " << (swapInterval == 0 ? "off" : swapInterval < 0 ? "adaptive" : "on");
+    if (config.pacing.maxFps > 0.0) {
+        std::cout << ", capped at " << config.pacing.maxFps << " fps";
+    }
+    if (config.pacing.lowLatency && framePacer->isActive()) {
+        std::cout << ", low latency";
+    }
+    std::cout << std::endl;
+}
+
 bool Application::initGLAD() {
     return gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 }
@@ -199,27 +550,227 @@ void Application::initShader() {
 
     shaders.clear();
     shaderNames.clear();
+    shaderIsCellPass.clear();
+    shaderPaths.clear();
+    shaderReloads.clear();
+    shaderWriteTimes.clear();
+
+    std::string cacheDir = config.render.shaderCacheDir;
+    if (cacheDir.empty()) {
+        const char* cacheHome = getenv("XDG_CACHE_HOME");
+        const char* homeDir = getenv("HOME");
+        if (cacheHome && *cacheHome) {
+            cacheDir = std::string(cacheHome) + "/frame_shader";
+        } else if (homeDir) {
+            cacheDir = std::string(homeDir) + "/.cache/frame_shader";
+        }
+    }
+    Shader::setBinaryCacheDirectory(config.render.shaderCache ? cacheDir : "");
+    if (Shader::enableParallelCompile((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Compiling shaders in the background with parallel shader compile." << std::endl;
+    }
 
+    const std::string& cellMode = config.render.cellGrid;
+    if (cellMode != "cpu" && cellMode != "gpu" && cellMode != "off") {
+        std::cerr << "Warning: Unknown cell_grid '" << cellMode << "'. Using cpu." << std::endl;
+    }
+    shaderDefines = cellMode != "off" ? "#define VIDEO_CELLS 1\n" : "";
+    if (config.render.glyphBits) {
+        shaderDefines += "#define GLYPH_BITS 1\n";
+    }
+    if (cellMode == "gpu") {
+        cellGridProgram = Shader::compute("shaders/comp/cell_grid.comp");
+        if (!cellGridProgram) {
+            std::cerr << "Warning: Could not build the cell grid compute pass. Reducing cells on the CPU." << std::endl;
+        }
+    }
+
+    // Only the paths are collected here; completeShader() builds them.
     for (const auto& path : fragmentShaderPaths) {
-        try {
-            shaders.push_back(std::make_unique<Shader>("shaders/vert/shader.vert", path.c_str()));
-            std::cout << "Loaded shader: " << path << std::endl;
-            
-            std::string pathStr = path;
-            size_t last_slash = pathStr.find_last_of("/\\");
-            last_slash = (last_slash == std::string::npos) ? 0 : last_slash + 1;
-            size_t last_dot = pathStr.find_last_of('.');
-            std::string shortName = pathStr.substr(last_slash, last_dot - last_slash);
-            shaderNames.push_back(shortName);
+        std::string pathStr = path;
+        size_t last_slash = pathStr.find_last_of("/\\");
+        last_slash = (last_slash == std::string::npos) ? 0 : last_slash + 1;
+        size_t last_dot = pathStr.find_last_of('.');
+        std::string shortName = pathStr.substr(last_slash, last_dot - last_slash);
+        shaders.emplace_back();
+        shaderPaths.push_back(path);
+        shaderNames.push_back(shortName);
+        shaderIsCellPass.push_back(false);
+    }
 
-        } catch (const std::exception& e) {
-            std::cerr << "Failed to load shader " << path << ": " << e.what() << std::endl;
+    // Cell effects run their per-cell work once per cell in a compute pass
+    // and share one glyph expansion shader. They are listed as "cell/<name>".
+    const std::string cellShaderDir = "shaders/cell";
+    glyphExpandShader = std::make_unique<Shader>("shaders/vert/shader.vert", "shaders/cell/expand.frag", shaderDefines);
+    if (!glyphExpandShader->isLinked()) {
+        std::cerr << "Warning: Could not build the glyph expansion shader. Cell effects are disabled." << std::endl;
+        glyphExpandShader.reset();
+    }
+    std::vector<std::filesystem::path> cellShaderPaths;
+    if (glyphExpandShader && std::filesystem::is_directory(cellShaderDir)) {
+        for (const auto& entry : std::filesystem::directory_iterator(cellShaderDir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".comp") {
+                cellShaderPaths.push_back(entry.path());
+            }
         }
     }
+    std::sort(cellShaderPaths.begin(), cellShaderPaths.end());
+    for (const auto& path : cellShaderPaths) {
+        shaders.emplace_back();
+        shaderPaths.push_back(path.string());
+        shaderNames.push_back("cell/" + path.stem().string());
+        shaderIsCellPass.push_back(true);
+    }
 
     if (shaders.empty()) {
         throw std::runtime_error("No shaders could be loaded. Exiting.");
     }
+
+    shaderReloads.resize(shaders.size());
+    shaderWriteTimes.resize(shaders.size());
+
+    // Startup only waits for the shader that is shown first; the rest are
+    // finished by pumpShaderCompiles() while it runs.
+    currentShaderIndex = 0;
+    if (!config.selectedShader.empty()) {
+        auto it = std::find(shaderNames.begin(), shaderNames.end(), config.selectedShader);
+        if (it != shaderNames.end()) {
+            currentShaderIndex = static_cast<int>(std::distance(shaderNames.begin(), it));
+        } else {
+            std::cerr << "Warning: Selected shader '" << config.selectedShader
+                      << "' not found. Starting with the first shader." << std::endl;
+        }
+    }
+    while (!completeShader(currentShaderIndex)) {
+        if (shaders.empty()) {
+            throw std::runtime_error("No shaders could be loaded. Exiting.");
+        }
+        currentShaderIndex %= static_cast<int>(shaders.size());
+    }
+    shaderCompilesPending = shaders.size() > 1;
+}
+
+// A deferred build of entry `index` from its current source, so with
+// parallel compile this returns before the driver is done with it.
+std::unique_ptr<Shader> Application::createShader(size_t index) const {
+    const std::string& path = shaderPaths[index];
+    if (shaderIsCellPass[index]) {
+        return Shader::compute(path.c_str(), shaderDefines, true);
+    }
+    return std::make_unique<Shader>("shaders/vert/shader.vert", path.c_str(), shaderDefines, true);
+}
+
+// Queues the program of shaders[index] with the driver unless it already
+// has been.
+void Application::submitShader(size_t index) {
+    if (shaders[index]) {
+        return;
+    }
+    shaders[index] = createShader(index);
+    if (shaders[index]) {
+        shaderWriteTimes[index] = newestWriteTime(shaders[index]->getSourceFiles());
+    }
+}
+
+// Builds shaders[index] if need be and waits for it. One that fails to
+// compile or link is dropped from the list, in which case this returns false.
+bool Application::completeShader(size_t index) {
+    submitShader(index);
+    Shader* shader = shaders[index].get();
+    if (shader) {
+        shader->finish();
+    }
+    if (shader && shader->isLinked()) {
+        std::cout << "Loaded " << (shaderIsCellPass[index] ? "cell shader: " : "shader: ") << shaderPaths[index]
+                  << (shader->isFromBinaryCache() ? " (cached)" : "") << std::endl;
+        return true;
+    }
+
+    std::cerr << "Failed to load " << (shaderIsCellPass[index] ? "cell shader " : "shader ") << shaderPaths[index]
+              << std::endl;
+    shaders.erase(shaders.begin() + index);
+    shaderPaths.erase(shaderPaths.begin() + index);
+    shaderNames.erase(shaderNames.begin() + index);
+    shaderIsCellPass.erase(shaderIsCellPass.begin() + index);
+    shaderReloads.erase(shaderReloads.begin() + index);
+    shaderWriteTimes.erase(shaderWriteTimes.begin() + index);
+    if (static_cast<int>(index) < currentShaderIndex) {
+        --currentShaderIndex;
+    }
+    return false;
+}
+
+// Called once per frame after the swap. With parallel compile every
+// remaining program is submitted at once and collected as the driver
+// finishes it; without it, one program is built per frame so no single
+// frame pays for the whole library.
+void Application::pumpShaderCompiles() {
+    if (!shaderCompilesPending) {
+        return;
+    }
+    const bool parallel = Shader::hasParallelCompile();
+    bool builtOne = false;
+    shaderCompilesPending = false;
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        if (shaders[i] && shaders[i]->isComplete()) {
+            continue;
+        }
+        if (!parallel && builtOne) {
+            shaderCompilesPending = true;
+            break;
+        }
+        submitShader(i);
+        if (shaders[i] && !shaders[i]->isReady()) {
+            shaderCompilesPending = true;
+            continue;
+        }
+        builtOne = true;
+        if (!completeShader(i)) {
+            --i; // The next shader moved into this slot
+        }
+    }
+}
+
+// Rebuilds any shader whose source, or a file it includes, changed on
+// disk. The new program is compiled like a background one and only
+// replaces the old between frames once it has linked, so a shader saved
+// with a typo keeps running its last working version.
+void Application::pollShaderReloads() {
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        std::unique_ptr<Shader>& reload = shaderReloads[i];
+        if (!reload || !reload->isReady()) {
+            continue;
+        }
+        reload->finish();
+        if (reload->isLinked()) {
+            shaders[i] = std::move(reload);
+            std::cout << "Reloaded shader: " << shaderNames[i] << std::endl;
+            if (static_cast<int>(i) == currentShaderIndex) {
+                updateActiveShaderUniforms();
+            }
+        } else {
+            std::cerr << "Warning: Keeping the last working build of " << shaderNames[i] << "." << std::endl;
+        }
+        reload.reset();
+    }
+
+    const double now = glfwGetTime();
+    if (now - lastShaderPollTime < kShaderPollSeconds) {
+        return;
+    }
+    lastShaderPollTime = now;
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        if (!shaders[i] || !shaders[i]->isComplete() || shaderReloads[i]) {
+            continue;
+        }
+        const std::filesystem::file_time_type written = newestWriteTime(shaders[i]->getSourceFiles());
+        if (written <= shaderWriteTimes[i]) {
+            continue;
+        }
+        // Recorded even if the build fails, so it is retried on the next save.
+        shaderWriteTimes[i] = written;
+        shaderReloads[i] = createShader(i);
+    }
 }
 
 // TODO: This is triggered whenever the configuration file changes. Potential to make this more efficient
@@ -320,23 +871,58 @@ void Application::initGeometry() {
     glEnableVertexAttribArray(1);
 }
 
+void Application::initFrameConstants() {
+    glGenBuffers(1, &frameConstantsBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameConstantsBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), &frameConstants, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, frameConstantsBuffer);
+}
+
+// One buffer write per frame instead of setting uniforms by name on each
+// program.
+void Application::writeFrameConstants() {
+    glBindBuffer(GL_UNIFORM_BUFFER, frameConstantsBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameConstants), &frameConstants);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
 void Application::initTextures() {
-    glGenTextures(1, &videoTexture);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, videoTexture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    videoTexture = std::make_unique<VideoTexture>(static_cast<int>(frameSources.size()), config.render.uploadBuffers);
+    videoTexture->setProfiler(gpuProfiler.get());
+    if (config.render.persistentMapping) {
+        for (size_t i = 0; i < frameSources.size(); ++i) {
+            size_t slotBytes = frameSources[i]->getSlotBytes();
+            if (slotBytes == 0) {
+                continue; // The source hands out its own memory
+            }
+            std::vector<uint8_t*> slots = videoTexture->mapCaptureSlots(static_cast<int>(i), FrameSource::kFrameSlots, slotBytes);
+            if (slots.empty()) {
+                std::cerr << "Warning: Could not map capture buffers for source " << i << "; uploading through copies." << std::endl;
+                continue;
+            }
+            frameSources[i]->setSlotStorage(slots);
+        }
+    }
+
+    renderTarget = std::make_unique<RenderTarget>();
 
     const FontProfile& currentFont = getCurrentFontProfile();
     loadTextureFromFile(currentFont.path.c_str(), fontTexture, GL_TEXTURE1);
+    uploadGlyphBits();
 
     glGenTextures(1, &maskTexture);
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, maskTexture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    // Initialize with empty data; it will be updated each frame
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, camera->getWidth(), camera->getHeight(), 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // The model's logits, as they come; start out as all background.
+    const int maskWidth = segmentationModel->getOutputWidth();
+    const int maskHeight = segmentationModel->getOutputHeight();
+    std::vector<float> background(static_cast<size_t>(maskWidth) * maskHeight, -16.0f);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, maskWidth, maskHeight, 0, GL_RED, GL_FLOAT, background.data());
 }
 
 void Application::framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -357,15 +943,22 @@ void Application::updateActiveShaderUniforms() {
     const std::string& currentShaderName = shaderNames[currentShaderIndex];
     const FontProfile& currentFont = getCurrentFontProfile();
 
+    // Samplers are bound in the shaders, and the font and render metrics
+    // live in the frame constants that every program shares.
+    updateRenderTarget();
+    frameConstants.charSize[0] = currentFont.charWidth;
+    frameConstants.charSize[1] = currentFont.charHeight;
+    frameConstants.numChars = currentFont.numChars;
+
     currentShader->use();
-    currentShader->setInt("videoTexture", 0);
-    currentShader->setInt("fontAtlas", 1);
-    currentShader->setInt("maskTexture", 2); // NEW: Set mask texture uniform
-    currentShader->setVec2("resolution", (float)camera->getWidth(), (float)camera->getHeight());
-    currentShader->setVec2("charSize", currentFont.charWidth, currentFont.charHeight);
-    currentShader->setFloat("numChars", currentFont.numChars);
+    currentShader->setInt("videoFormat", static_cast<int>(frameSources[0]->getPixelFormat()));
+    updateVideoLayout(*currentShader);
 
     auto it = config.shaderConfigs.find(currentShaderName);
+    if (it == config.shaderConfigs.end() && shaderIsCellPass[currentShaderIndex]) {
+        // A cell port takes the settings of the full-screen shader it mirrors.
+        it = config.shaderConfigs.find(currentShaderName.substr(currentShaderName.find('/') + 1));
+    }
     if (it != config.shaderConfigs.end()) {
         const ShaderConfig& shaderConf = it->second;
         for (const auto& pair : shaderConf) {
@@ -379,6 +972,168 @@ void Application::updateActiveShaderUniforms() {
     } else {
         std::cout << "Shader '" << currentShaderName << "' does not use segmentation mask. Model is DISABLED." << std::endl;
     }
+
+    if (shaderIsCellPass[currentShaderIndex]) {
+        updateCellPass();
+    }
+
+    currentShaderUsesFrames = currentShader->usesUniform("videoTexture") || currentShader->usesUniform("videoChromaTexture");
+    currentShaderUsesCells = currentShader->usesUniform("videoCellTexture");
+
+    updateCaptureResolution();
+}
+
+// Sizes the offscreen target the shaders draw into and publishes that size
+// as the `resolution` frame constant. Runs with updateActiveShaderUniforms(),
+// so font switches re-snap it and config reloads pick up new settings.
+void Application::updateRenderTarget() {
+    const FontProfile& currentFont = getCurrentFontProfile();
+    cv::Size size(config.render.renderWidth > 0 ? config.render.renderWidth : frameSources[0]->getWidth(),
+                  config.render.renderHeight > 0 ? config.render.renderHeight : frameSources[0]->getHeight());
+    if (config.render.snapToCells) {
+        const int charWidth = std::max(1, static_cast<int>(std::lround(currentFont.charWidth)));
+        const int charHeight = std::max(1, static_cast<int>(std::lround(currentFont.charHeight)));
+        size.width = std::max(1, size.width / charWidth) * charWidth;
+        size.height = std::max(1, size.height / charHeight) * charHeight;
+    }
+    if (!RenderTarget::parseUpscale(config.render.upscale, upscale)) {
+        std::cerr << "Warning: Unknown upscale '" << config.render.upscale << "'. Using linear." << std::endl;
+        upscale = RenderTarget::Upscale::Linear;
+    }
+    renderTarget->resize(size);
+    frameConstants.resolution[0] = static_cast<float>(size.width);
+    frameConstants.resolution[1] = static_cast<float>(size.height);
+}
+
+// The shaders sample the video once per character cell, so the capture side
+// only has to deliver one pixel per cell (or the model's input size while
+// the segmentation mask is in use). In a grid each camera only fills one
+// tile. Runs whenever the font or shader changes, and also sizes the cell
+// texture that sampleCell() reads to the same cells per camera. Expects the
+// current shader to be in use.
+void Application::updateCaptureResolution() {
+    const FontProfile& currentFont = getCurrentFontProfile();
+    const cv::Size renderSize = renderTarget->getSize();
+    const double outputWidth = renderSize.width;
+    const double outputHeight = renderSize.height;
+    videoTexture->setCellGrid(cv::Size2f(static_cast<float>(outputWidth / gridSize.width / currentFont.charWidth),
+                                         static_cast<float>(outputHeight / gridSize.height / currentFont.charHeight)));
+    const cv::Size2f cellExtent = videoTexture->getCellExtent();
+    shaders[currentShaderIndex]->setVec2("videoCellExtent", cellExtent.width, cellExtent.height);
+    const cv::Size cells = videoTexture->getCellGrid();
+    for (size_t i = 0; i < frameSources.size(); ++i) {
+        FrameSource& source = *frameSources[i];
+        int width = cells.width;
+        int height = cells.height;
+        if (i == 0 && currentShaderUsesMask) {
+            width = std::max(width, segmentationModel->getInputWidth());
+            height = std::max(height, segmentationModel->getInputHeight());
+        }
+        source.setTargetResolution(width, height);
+    }
+}
+
+// Tells video.glsl how to composite the cameras. The grid is columns x rows
+// tiles over the whole window; the layered mode blends every camera by its
+// opacity.
+void Application::updateVideoLayout(const Shader& shader) {
+    const int layerCount = static_cast<int>(frameSources.size());
+    const bool layered = config.layout.mode == "layered";
+    if (!layered && config.layout.mode != "grid") {
+        std::cerr << "Warning: Unknown layout '" << config.layout.mode << "'. Using grid." << std::endl;
+    }
+
+    int columns = config.layout.columns > 0
+        ? std::min(config.layout.columns, layerCount)
+        : static_cast<int>(std::ceil(std::sqrt(static_cast<double>(layerCount))));
+    int rows = (layerCount + columns - 1) / columns;
+    gridSize = layered ? cv::Size(1, 1) : cv::Size(columns, rows);
+
+    shader.setInt("videoLayerCount", layerCount);
+    shader.setInt("videoLayout", layered ? 1 : 0);
+    shader.setIVec2("videoGrid", gridSize.width, gridSize.height);
+    if (layerCount > 1) {
+        std::vector<CameraSettings> cameras = camera_settings_list(config);
+        for (int i = 0; i < layerCount && i < static_cast<int>(cameras.size()); ++i) {
+            shader.setFloat(kLayerWeightNames[i], cameras[i].opacity);
+        }
+    }
+}
+
+// Sizes the cell buffer to the character grid over the output and hands
+// the grid to both stages of the current cell effect.
+void Application::updateCellPass() {
+    const FontProfile& currentFont = getCurrentFontProfile();
+    const cv::Size renderSize = renderTarget->getSize();
+    const cv::Size grid(static_cast<int>(std::ceil(renderSize.width / currentFont.charWidth)),
+                        static_cast<int>(std::ceil(renderSize.height / currentFont.charHeight)));
+    if (cellBuffer == 0) {
+        glGenBuffers(1, &cellBuffer);
+    }
+    if (grid != cellPassGrid) {
+        cellPassGrid = grid;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(grid.area()) * 2 * sizeof(GLuint), nullptr,
+                     GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    shaders[currentShaderIndex]->setIVec2("cellGridSize", grid.width, grid.height);
+    glyphExpandShader->use();
+    glyphExpandShader->setIVec2("cellGridSize", grid.width, grid.height);
+    shaders[currentShaderIndex]->use();
+}
+
+// Packs the current font into the storage buffer glyph.glsl reads when
+// GLYPH_BITS is defined.
+void Application::uploadGlyphBits() {
+    if (!config.render.glyphBits) {
+        return;
+    }
+    const FontProfile& font = getCurrentFontProfile();
+    cv::Mat atlas = cv::imread(font.path, cv::IMREAD_COLOR);
+    if (atlas.empty()) {
+        std::cerr << "Warning: Could not read " << font.path << " for glyph bits." << std::endl;
+    }
+    std::vector<uint32_t> words = GlyphBits::pack(atlas, static_cast<int>(font.charWidth),
+                                                  static_cast<int>(font.charHeight), static_cast<int>(font.numChars));
+    if (words.empty()) {
+        words.push_back(0); // Keep the buffer bound and non-empty
+    }
+    if (glyphBuffer == 0) {
+        glGenBuffers(1, &glyphBuffer);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, glyphBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(words.size() * sizeof(uint32_t)), words.data(),
+                 GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, glyphBuffer);
+}
+
+void Application::updateVideoLayerScales(const Shader& shader) {
+    for (int i = 0; i < videoTexture->getLayerCount(); ++i) {
+        cv::Point2f scale = videoTexture->getLayerScale(i);
+        shader.setVec2(kLayerScaleNames[i], scale.x, scale.y);
+    }
+}
+
+// Steps to the next (1) or previous (-1) shader, waiting for it if it is
+// still compiling and skipping any that turn out not to build.
+void Application::switchShader(int step) {
+    int index = currentShaderIndex;
+    while (true) {
+        const int count = static_cast<int>(shaders.size());
+        index = (index + step + count) % count;
+        if (completeShader(index)) {
+            break;
+        }
+        if (step > 0) {
+            --index; // The next shader moved into this slot
+        }
+    }
+    currentShaderIndex = index;
+    updateActiveShaderUniforms();
+    std::cout << "Switched to shader: " << shaderNames[currentShaderIndex] << std::endl;
 }
 
 void Application::reloadFontTexture() {
@@ -389,6 +1144,7 @@ void Application::reloadFontTexture() {
 
     glDeleteTextures(1, &fontTexture);
     loadTextureFromFile(newFont.path.c_str(), fontTexture, GL_TEXTURE1);
+    uploadGlyphBits();
     updateActiveShaderUniforms();
 }
 
@@ -403,14 +1159,10 @@ void Application::handleKey(int key, int action) {
         }
         
         if (key == GLFW_KEY_RIGHT) {
-            currentShaderIndex = (currentShaderIndex + 1) % shaders.size();
-            updateActiveShaderUniforms();
-            std::cout << "Switched to shader: " << shaderNames[currentShaderIndex] << std::endl;
+            switchShader(1);
         }
         if (key == GLFW_KEY_LEFT) {
-            currentShaderIndex = (currentShaderIndex + shaders.size() - 1) % shaders.size();
-            updateActiveShaderUniforms();
-            std::cout << "Switched to shader: " << shaderNames[currentShaderIndex] << std::endl;
+            switchShader(-1);
         }
         
         if (key == GLFW_KEY_UP) {
@@ -439,6 +1191,9 @@ void Application::reloadConfiguration() {
     // Re-parse the ini file over our existing config struct
     load_from_ini(config);
     initFonts();
+    for (const auto& source : frameSources) {
+        source->setChangeTolerance(config.source.staticTolerance);
+    }
     
     // Re-apply the new settings to the currently active shader
     updateActiveShaderUniforms();
@@ -1,35 +1,60 @@
 #include "Camera.h"
+#include "CameraModes.h"
+#include "OpenCVCapture.h"
+#include "V4L2Capture.h"
 #include <iostream>
 
-Camera::Camera(int deviceID, int width, int height) {
-    cap.open(deviceID, cv::CAP_V4L2);
-    if (!cap.isOpened()) {
-        std::cerr << "ERROR: Could not open camera." << std::endl;
+Camera::Camera(const CameraSettings& settings) {
+    if (settings.backend == "v4l2") {
+        backend = std::make_unique<V4L2Capture>(cameraDevicePath(settings), settings);
+    } else {
+        if (settings.backend != "opencv") {
+            std::cerr << "Warning: Unknown camera backend '" << settings.backend << "'. Using opencv." << std::endl;
+        }
+        backend = std::make_unique<OpenCVCapture>(settings);
+    }
+    if (!backend->isOpened()) {
         return;
     }
 
-    cap.set(cv::CAP_PROP_FRAME_WIDTH, width);
-    cap.set(cv::CAP_PROP_FRAME_HEIGHT, height);
-
-    frameWidth = cap.get(cv::CAP_PROP_FRAME_WIDTH);
-    frameHeight = cap.get(cv::CAP_PROP_FRAME_HEIGHT);
+    frameWidth = backend->getWidth();
+    frameHeight = backend->getHeight();
 
     std::cout << "Camera initialized with resolution: " 
               << frameWidth << "x" << frameHeight << std::endl;
+
+    // Backends that decode into the frame do so in place instead of
+    // allocating a fresh buffer per frame.
+    if (backend->fillsFrameStorage()) {
+        preallocateSlots(frameWidth, frameHeight, CV_8UC3);
+    }
+
+    // The driver paces capture, so no frame interval here.
+    start();
 }
 
 Camera::~Camera() {
-    if (cap.isOpened()) {
-        cap.release();
-    }
+    stop();
 }
 
-bool Camera::isOpened() const {
-    return cap.isOpened();
+bool Camera::produce(Frame& frame) {
+    return backend->grab(frame);
+}
+
+void Camera::recycle(Frame& frame) {
+    backend->release(frame);
 }
 
-bool Camera::read(cv::Mat& frame) {
-    return cap.read(frame);
+void Camera::interruptProducer() {
+    backend->interrupt();
+}
+
+bool Camera::keepsSlotBuffers() const {
+    return !backend->swapsFrameStorage();
+}
+
+bool Camera::isOpened() const {
+    return backend->isOpened();
 }
 
 int Camera::getWidth() const {
@@ -39,3 +64,11 @@ int Camera::getWidth() const {
 int Camera::getHeight() const {
     return frameHeight;
 }
+
+PixelFormat Camera::getPixelFormat() const {
+    return backend->getPixelFormat();
+}
+
+void Camera::setTargetResolution(int width, int height) {
+    backend->setTargetResolution(width, height);
+}
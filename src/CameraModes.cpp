@@ -0,0 +1,170 @@
+#include "CameraModes.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <tuple>
+#include <linux/videodev2.h>
+
+namespace {
+// Relative per-pixel cost of getting a frame onto the GPU: bytes uploaded
+// for the raw formats, CPU decode (even at reduced scale) for MJPEG.
+double formatCost(uint32_t fourcc) {
+    switch (fourcc) {
+    case V4L2_PIX_FMT_NV12: return 1.5;
+    case V4L2_PIX_FMT_YUYV: return 2.0;
+    case V4L2_PIX_FMT_BGR24: return 3.0;
+    case V4L2_PIX_FMT_MJPEG: return 4.0;
+    default: return 0.0;
+    }
+}
+
+bool isUsableFormat(uint32_t fourcc) {
+    return formatCost(fourcc) > 0.0;
+}
+
+// Closest value to `target` in min, min + step, ..., max.
+uint32_t closestStep(uint32_t target, uint32_t min, uint32_t max, uint32_t step) {
+    if (target <= min) return min;
+    if (target >= max) return max;
+    step = std::max<uint32_t>(step, 1);
+    return min + (target - min + step / 2) / step * step;
+}
+
+double intervalToFps(const v4l2_fract& interval) {
+    return interval.numerator ? static_cast<double>(interval.denominator) / interval.numerator : 0.0;
+}
+
+void addIntervals(V4L2Device& device, uint32_t fourcc, int width, int height, double targetFps,
+                  std::vector<CameraMode>& modes) {
+    v4l2_frmivalenum interval{};
+    interval.pixel_format = fourcc;
+    interval.width = width;
+    interval.height = height;
+    bool any = false;
+    for (interval.index = 0; device.ioctl(VIDIOC_ENUM_FRAMEINTERVALS, &interval) == 0; ++interval.index) {
+        any = true;
+        if (interval.type == V4L2_FRMIVAL_TYPE_DISCRETE) {
+            modes.push_back({fourcc, width, height, intervalToFps(interval.discrete)});
+            continue;
+        }
+        // Stepwise or continuous: the longest interval is the lowest rate.
+        double minFps = intervalToFps(interval.stepwise.max);
+        double maxFps = intervalToFps(interval.stepwise.min);
+        modes.push_back({fourcc, width, height, std::clamp(targetFps, minFps, maxFps)});
+        break;
+    }
+    if (!any) {
+        modes.push_back({fourcc, width, height, 0.0});
+    }
+}
+} // namespace
+
+std::string fourccToString(uint32_t fourcc) {
+    return {static_cast<char>(fourcc & 0xFF), static_cast<char>((fourcc >> 8) & 0xFF),
+            static_cast<char>((fourcc >> 16) & 0xFF), static_cast<char>((fourcc >> 24) & 0xFF)};
+}
+
+uint32_t fourccFromName(const std::string& name) {
+    if (name == "auto") return 0;
+    if (name == "mjpeg") return V4L2_PIX_FMT_MJPEG;
+    if (name == "nv12") return V4L2_PIX_FMT_NV12;
+    if (name == "bgr24") return V4L2_PIX_FMT_BGR24;
+    if (name != "yuyv") {
+        std::cerr << "Warning: Unknown camera format '" << name << "'. Requesting yuyv." << std::endl;
+    }
+    return V4L2_PIX_FMT_YUYV;
+}
+
+std::string cameraDevicePath(const CameraSettings& settings) {
+    return settings.devicePath.empty() ? "/dev/video" + std::to_string(settings.deviceID) : settings.devicePath;
+}
+
+std::vector<CameraMode> enumerateCameraModes(V4L2Device& device, const CameraSettings& settings) {
+    std::vector<CameraMode> modes;
+    v4l2_fmtdesc format{};
+    format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    for (format.index = 0; device.ioctl(VIDIOC_ENUM_FMT, &format) == 0; ++format.index) {
+        if (!isUsableFormat(format.pixelformat)) {
+            continue;
+        }
+        v4l2_frmsizeenum size{};
+        size.pixel_format = format.pixelformat;
+        for (size.index = 0; device.ioctl(VIDIOC_ENUM_FRAMESIZES, &size) == 0; ++size.index) {
+            if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE) {
+                addIntervals(device, format.pixelformat, size.discrete.width, size.discrete.height,
+                             settings.fps, modes);
+                continue;
+            }
+            const v4l2_frmsize_stepwise& range = size.stepwise;
+            int width = closestStep(settings.width, range.min_width, range.max_width, range.step_width);
+            int height = closestStep(settings.height, range.min_height, range.max_height, range.step_height);
+            addIntervals(device, format.pixelformat, width, height, settings.fps, modes);
+            break;
+        }
+    }
+    return modes;
+}
+
+bool chooseCameraMode(const std::vector<CameraMode>& modes, const CameraSettings& settings, CameraMode& chosen) {
+    const uint32_t requiredFourcc = fourccFromName(settings.pixelFormat);
+    const double targetFps = settings.fps;
+    const double targetArea = static_cast<double>(settings.width) * settings.height;
+
+    // Lower tuples are better: reaching the frame rate matters most (and if
+    // nothing does, the fastest mode wins), then the resolution, then
+    // throughput cost, or for modes below the target size, staying as close
+    // to it as possible. The cheaper format, then the lower frame rate,
+    // break remaining ties.
+    auto rank = [&](const CameraMode& mode) {
+        // Allow for drivers that report 29.97 for "30".
+        bool fastEnough = mode.fps == 0.0 || targetFps <= 0.0 || mode.fps >= targetFps * 0.98;
+        bool bigEnough = mode.width >= settings.width && mode.height >= settings.height;
+        double area = static_cast<double>(mode.width) * mode.height;
+        double rate = mode.fps > 0.0 && targetFps > 0.0 ? std::min(mode.fps, targetFps) : 1.0;
+        double cost = bigEnough ? area * rate * formatCost(mode.fourcc) : targetArea - area;
+        return std::make_tuple(!fastEnough, fastEnough ? 0.0 : -mode.fps, !bigEnough, cost,
+                               formatCost(mode.fourcc), mode.fps);
+    };
+
+    const CameraMode* best = nullptr;
+    for (const CameraMode& mode : modes) {
+        if (requiredFourcc != 0 && mode.fourcc != requiredFourcc) {
+            continue;
+        }
+        if (!best || rank(mode) < rank(*best)) {
+            best = &mode;
+        }
+    }
+    if (!best) {
+        return false;
+    }
+    chosen = *best;
+    return true;
+}
+
+void printCameraModes(const CameraSettings& settings) {
+    const std::string path = cameraDevicePath(settings);
+    std::unique_ptr<V4L2Device> device = V4L2Device::open(path);
+    if (!device->isOpen()) {
+        return;
+    }
+    std::vector<CameraMode> modes = enumerateCameraModes(*device, settings);
+    if (modes.empty()) {
+        std::cout << path << ": the driver does not enumerate any usable modes." << std::endl;
+        return;
+    }
+
+    CameraMode chosen;
+    bool haveChoice = chooseCameraMode(modes, settings, chosen);
+    std::cout << path << " (target " << settings.width << "x" << settings.height << " at " << settings.fps
+              << " fps, format " << settings.pixelFormat << "):" << std::endl;
+    for (const CameraMode& mode : modes) {
+        bool isChoice = haveChoice && mode.fourcc == chosen.fourcc && mode.width == chosen.width &&
+                        mode.height == chosen.height && mode.fps == chosen.fps;
+        char line[96];
+        std::snprintf(line, sizeof(line), "  %s %s %5dx%-5d %6.2f fps", isChoice ? "*" : " ",
+                      fourccToString(mode.fourcc).c_str(), mode.width, mode.height, mode.fps);
+        std::cout << line << std::endl;
+    }
+}
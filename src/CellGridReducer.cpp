@@ -0,0 +1,191 @@
+#include "CellGridReducer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CELL_GRID_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+// A uint16_t accumulator holds 257 rows of 255 before it can overflow.
+constexpr int kRowsPerFold = 256;
+
+using AccumulateFn = void (*)(const uint8_t* row, uint16_t* sums, size_t count);
+
+// sums[i] += row[i]
+void accumulateRowScalar(const uint8_t* row, uint16_t* sums, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        sums[i] = static_cast<uint16_t>(sums[i] + row[i]);
+    }
+}
+
+#if defined(CELL_GRID_X86)
+void accumulateRowSse2(const uint8_t* row, uint16_t* sums, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i* low = reinterpret_cast<__m128i*>(sums + i);
+        __m128i* high = reinterpret_cast<__m128i*>(sums + i + 8);
+        _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(bytes, zero)));
+        _mm_storeu_si128(high, _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(bytes, zero)));
+    }
+    accumulateRowScalar(row + i, sums + i, count - i);
+}
+
+__attribute__((target("avx2")))
+void accumulateRowAvx2(const uint8_t* row, uint16_t* sums, size_t count) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i low = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+        __m256i high = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i + 16)));
+        __m256i* lowSums = reinterpret_cast<__m256i*>(sums + i);
+        __m256i* highSums = reinterpret_cast<__m256i*>(sums + i + 16);
+        _mm256_storeu_si256(lowSums, _mm256_add_epi16(_mm256_loadu_si256(lowSums), low));
+        _mm256_storeu_si256(highSums, _mm256_add_epi16(_mm256_loadu_si256(highSums), high));
+    }
+    accumulateRowScalar(row + i, sums + i, count - i);
+}
+#elif defined(__ARM_NEON)
+void accumulateRowNeon(const uint8_t* row, uint16_t* sums, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t bytes = vld1q_u8(row + i);
+        vst1q_u16(sums + i, vaddw_u8(vld1q_u16(sums + i), vget_low_u8(bytes)));
+        vst1q_u16(sums + i + 8, vaddw_u8(vld1q_u16(sums + i + 8), vget_high_u8(bytes)));
+    }
+    accumulateRowScalar(row + i, sums + i, count - i);
+}
+#endif
+
+AccumulateFn pickAccumulate() {
+#if defined(CELL_GRID_X86)
+    return __builtin_cpu_supports("avx2") ? accumulateRowAvx2 : accumulateRowSse2;
+#elif defined(__ARM_NEON)
+    return accumulateRowNeon;
+#else
+    return accumulateRowScalar;
+#endif
+}
+
+// Pixels [first, second) of cell `index` along an axis of `size` pixels
+// split into `extent` cells, computed in float as cell_grid.comp does. The
+// last, partial cell is cut off at the frame edge, and a cell smaller than
+// a pixel still takes the one it starts in.
+std::pair<int, int> cellSpan(int index, int size, float extent) {
+    const auto edge = [&](int i) {
+        return std::min(size, static_cast<int>(std::floor(static_cast<float>(i) * static_cast<float>(size) / extent)));
+    };
+    const int first = std::min(edge(index), size - 1);
+    return {first, std::max(edge(index + 1), first + 1)};
+}
+
+// Mean of a cell in BT.601 limited range to BGR, the same conversion as
+// yuvToRgb() in video.glsl. The conversion is affine, so converting the
+// mean gives the mean of the converted pixels (up to clamping).
+void yuvToBgr(float y, float cb, float cr, uint8_t* bgr) {
+    y = (y - 16.0f) * 1.164f;
+    cb -= 128.0f;
+    cr -= 128.0f;
+    const float rgb[3] = {y + 1.596f * cr, y - 0.392f * cb - 0.813f * cr, y + 2.017f * cb};
+    for (int channel = 0; channel < 3; ++channel) {
+        bgr[2 - channel] = static_cast<uint8_t>(std::clamp(rgb[channel] + 0.5f, 0.0f, 255.0f));
+    }
+}
+} // namespace
+
+void CellGridReducer::reduce(const Frame& frame, cv::Size2f extent, cv::Mat& cells) {
+    static const AccumulateFn accumulateRow = pickAccumulate();
+    const PixelFormat format = frame.format;
+    const cv::Mat& image = frame.image;
+    const int width = frame.width();
+    const int height = frame.height();
+    const float columnExtent = std::max(1.0f, extent.width);
+    const float rowExtent = std::max(1.0f, extent.height);
+    const int columns = static_cast<int>(std::ceil(columnExtent));
+    const int rows = static_cast<int>(std::ceil(rowExtent));
+    cells.create(rows, columns, CV_8UC4);
+    const int expectedType = format == PixelFormat::YUYV ? CV_8UC2 : format == PixelFormat::NV12 ? CV_8UC1 : CV_8UC3;
+    if (image.empty() || width == 0 || height == 0 || image.type() != expectedType) {
+        cells.setTo(cv::Scalar::all(0));
+        return;
+    }
+
+    // Each band of cell rows first sums pixel rows vertically (the SIMD
+    // part), then folds each cell's span of that row sum horizontally into
+    // three channels: B, G, R for BGR frames, otherwise Y, Cb, Cr, where
+    // every pixel counts its pair's chroma. NV12 chroma rows are summed
+    // once per pixel row they cover, so both planes weigh pixels alike.
+    const int bytesPerPixel = format == PixelFormat::BGR ? 3 : format == PixelFormat::YUYV ? 2 : 1;
+    const size_t rowValues = static_cast<size_t>(width) * bytesPerPixel;
+    const uint8_t* chromaPlane = format == PixelFormat::NV12 ? image.ptr<uint8_t>(height) : nullptr;
+    cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& band) {
+        std::vector<uint16_t> columnSums(rowValues);
+        std::vector<uint16_t> chromaSums(chromaPlane ? static_cast<size_t>(width) : 0);
+        std::vector<uint32_t> cellSums(static_cast<size_t>(columns) * 3);
+        for (int cellRow = band.start; cellRow < band.end; ++cellRow) {
+            const auto [y0, y1] = cellSpan(cellRow, height, rowExtent);
+            std::fill(cellSums.begin(), cellSums.end(), 0u);
+
+            for (int foldStart = y0; foldStart < y1; foldStart += kRowsPerFold) {
+                const int foldEnd = std::min(y1, foldStart + kRowsPerFold);
+                std::fill(columnSums.begin(), columnSums.end(), static_cast<uint16_t>(0));
+                std::fill(chromaSums.begin(), chromaSums.end(), static_cast<uint16_t>(0));
+                for (int y = foldStart; y < foldEnd; ++y) {
+                    accumulateRow(image.ptr<uint8_t>(y), columnSums.data(), rowValues);
+                    if (chromaPlane) {
+                        accumulateRow(chromaPlane + (y / 2) * image.step, chromaSums.data(), chromaSums.size());
+                    }
+                }
+                for (int column = 0; column < columns; ++column) {
+                    const auto [x0, x1] = cellSpan(column, width, columnExtent);
+                    uint32_t* sum = &cellSums[static_cast<size_t>(column) * 3];
+                    for (int x = x0; x < x1; ++x) {
+                        switch (format) {
+                        case PixelFormat::YUYV: // Y0 Cb Y1 Cr
+                            sum[0] += columnSums[2 * x];
+                            sum[1] += columnSums[4 * (x / 2) + 1];
+                            sum[2] += columnSums[4 * (x / 2) + 3];
+                            break;
+                        case PixelFormat::NV12:
+                            sum[0] += columnSums[x];
+                            sum[1] += chromaSums[2 * (x / 2)];
+                            sum[2] += chromaSums[2 * (x / 2) + 1];
+                            break;
+                        case PixelFormat::BGR:
+                        default:
+                            sum[0] += columnSums[3 * x + 0];
+                            sum[1] += columnSums[3 * x + 1];
+                            sum[2] += columnSums[3 * x + 2];
+                            break;
+                        }
+                    }
+                }
+            }
+
+            uint8_t* out = cells.ptr<uint8_t>(cellRow);
+            for (int column = 0; column < columns; ++column) {
+                const auto [x0, x1] = cellSpan(column, width, columnExtent);
+                const uint32_t area = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+                const uint32_t* sum = &cellSums[static_cast<size_t>(column) * 3];
+                uint8_t* cell = out + 4 * column;
+                if (format == PixelFormat::BGR) {
+                    for (int channel = 0; channel < 3; ++channel) {
+                        cell[channel] = static_cast<uint8_t>((sum[channel] + area / 2) / area);
+                    }
+                } else {
+                    const float scale = 1.0f / static_cast<float>(area);
+                    yuvToBgr(sum[0] * scale, sum[1] * scale, sum[2] * scale, cell);
+                }
+                // 0.2126 R + 0.7152 G + 0.0722 B in 8-bit fixed point.
+                cell[3] = static_cast<uint8_t>((54 * cell[2] + 183 * cell[1] + 19 * cell[0] + 128) >> 8);
+            }
+        }
+    });
+}
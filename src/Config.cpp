@@ -5,17 +5,88 @@
 #include <cxxopts.hpp>
 #include <ini.h>
 
+static void apply_camera_setting(CameraSettings& camera, const char* name, const char* value) {
+    if (strcmp(name, "device") == 0) camera.deviceID = std::stoi(value);
+    else if (strcmp(name, "width") == 0) camera.width = std::stoi(value);
+    else if (strcmp(name, "height") == 0) camera.height = std::stoi(value);
+    else if (strcmp(name, "fps") == 0) camera.fps = std::stod(value);
+    else if (strcmp(name, "backend") == 0) camera.backend = value;
+    else if (strcmp(name, "device_path") == 0) camera.devicePath = value;
+    else if (strcmp(name, "format") == 0) camera.pixelFormat = value;
+    else if (strcmp(name, "buffers") == 0) camera.bufferCount = std::stoi(value);
+    else if (strcmp(name, "decode_threads") == 0) camera.decodeThreads = std::stoi(value);
+    else if (strcmp(name, "opacity") == 0) camera.opacity = std::stof(value);
+}
+
 static int config_handler(void* user, const char* section, const char* name, const char* value) {
     AppConfig* pconfig = (AppConfig*)user;
     
     // Handle camera settings
     if (strcmp(section, "camera") == 0) {
-        if (strcmp(name, "device") == 0) pconfig->cameraDeviceID = std::stoi(value);
-        else if (strcmp(name, "width") == 0) pconfig->cameraWidth = std::stoi(value);
-        else if (strcmp(name, "height") == 0) pconfig->cameraHeight = std::stoi(value);
+        apply_camera_setting(pconfig->camera, name, value);
+        return 1;
+    }
+
+    // Additional cameras, e.g. [camera:1]. Applied on top of [camera] later,
+    // so they only need the keys that differ.
+    const char* camera_prefix = "camera:";
+    if (strncmp(section, camera_prefix, strlen(camera_prefix)) == 0) {
+        int index = std::atoi(section + strlen(camera_prefix));
+        if (index < 1) {
+            std::cerr << "Warning: Ignoring [" << section << "]; extra cameras are numbered from 1." << std::endl;
+            return 1;
+        }
+        pconfig->extraCameraOverrides[index][name] = value;
+        return 1;
+    }
+
+    if (strcmp(section, "layout") == 0) {
+        if (strcmp(name, "mode") == 0) pconfig->layout.mode = value;
+        else if (strcmp(name, "columns") == 0) pconfig->layout.columns = std::stoi(value);
         return 1;
     }
     
+    if (strcmp(section, "render") == 0) {
+        if (strcmp(name, "upload_buffers") == 0) pconfig->render.uploadBuffers = std::stoi(value);
+        else if (strcmp(name, "persistent_mapping") == 0) pconfig->render.persistentMapping = std::stoi(value) != 0;
+        else if (strcmp(name, "cell_grid") == 0) pconfig->render.cellGrid = value;
+        else if (strcmp(name, "glyph_bits") == 0) pconfig->render.glyphBits = std::stoi(value) != 0;
+        else if (strcmp(name, "shader_cache") == 0) pconfig->render.shaderCache = std::stoi(value) != 0;
+        else if (strcmp(name, "shader_cache_dir") == 0) pconfig->render.shaderCacheDir = value;
+        else if (strcmp(name, "shader") == 0) pconfig->selectedShader = value;
+        else if (strcmp(name, "render_width") == 0) pconfig->render.renderWidth = std::stoi(value);
+        else if (strcmp(name, "render_height") == 0) pconfig->render.renderHeight = std::stoi(value);
+        else if (strcmp(name, "snap_to_cells") == 0) pconfig->render.snapToCells = std::stoi(value) != 0;
+        else if (strcmp(name, "upscale") == 0) pconfig->render.upscale = value;
+        return 1;
+    }
+
+    if (strcmp(section, "source") == 0) {
+        if (strcmp(name, "type") == 0) pconfig->source.type = value;
+        else if (strcmp(name, "path") == 0) pconfig->source.path = value;
+        else if (strcmp(name, "fps") == 0) pconfig->source.fps = std::stod(value);
+        else if (strcmp(name, "paced") == 0) pconfig->source.paced = std::stoi(value) != 0;
+        else if (strcmp(name, "motion") == 0) pconfig->source.motion = std::stof(value);
+        else if (strcmp(name, "prefetch") == 0) pconfig->source.prefetch = std::stoi(value);
+        else if (strcmp(name, "static_tolerance") == 0) pconfig->source.staticTolerance = std::stof(value);
+        else if (strcmp(name, "record_path") == 0) pconfig->source.recordPath = value;
+        return 1;
+    }
+
+    if (strcmp(section, "pacing") == 0) {
+        if (strcmp(name, "vsync") == 0) pconfig->pacing.vsync = value;
+        else if (strcmp(name, "max_fps") == 0) pconfig->pacing.maxFps = std::stod(value);
+        else if (strcmp(name, "low_latency") == 0) pconfig->pacing.lowLatency = std::stoi(value) != 0;
+        return 1;
+    }
+
+    if (strcmp(section, "stats") == 0) {
+        if (strcmp(name, "latency_report") == 0) pconfig->stats.latencyReportSeconds = std::stod(value);
+        else if (strcmp(name, "latency_log") == 0) pconfig->stats.latencyLogPath = value;
+        else if (strcmp(name, "gpu_timers") == 0) pconfig->stats.gpuTimers = std::stoi(value) != 0;
+        return 1;
+    }
+
     // ## NEW LOGIC ##
     // Handle dynamic font profile sections like [font:default]
     const char* font_prefix = "font:";
@@ -59,7 +130,38 @@ static void parse_from_args(int argc, char* argv[], AppConfig& config) {
             ("d,device", "Camera device ID", cxxopts::value<int>())
             ("w,width", "Camera frame width", cxxopts::value<int>())
             ("h,height", "Camera frame height", cxxopts::value<int>())
+            ("b,backend", "Capture backend (opencv, v4l2)", cxxopts::value<std::string>())
+            ("device-path", "V4L2 device node, or fake:<file> for a raw-frame file", cxxopts::value<std::string>())
+            ("fps", "Camera frame rate to negotiate", cxxopts::value<double>())
+            ("format", "Camera pixel format (auto, yuyv, nv12, bgr24, mjpeg)", cxxopts::value<std::string>())
+            ("list-modes", "List the formats, sizes and frame rates of the configured cameras and exit")
+            ("c,cameras", "Comma-separated device IDs to composite, e.g. 0,2 (overrides --device)", cxxopts::value<std::vector<int>>())
+            ("layout", "Multi-camera layout (grid, layered)", cxxopts::value<std::string>())
+            ("upload-buffers", "Pixel buffers per video layer for asynchronous uploads (0 uploads synchronously)", cxxopts::value<int>())
+            ("no-persistent-mapping", "Don't capture straight into mapped GPU buffers")
+            ("cell-grid", "Per-cell colour reduction: cpu, gpu or off", cxxopts::value<std::string>())
+            ("glyph-bits", "Draw glyphs from bit-packed masks instead of the atlas texture")
+            ("render-width", "Internal render width (0 uses the source width)", cxxopts::value<int>())
+            ("render-height", "Internal render height (0 uses the source height)", cxxopts::value<int>())
+            ("snap-to-cells", "Round the render size down to whole character cells")
+            ("upscale", "Scaling of the render to the window: linear, nearest or integer", cxxopts::value<std::string>())
+            ("no-shader-cache", "Compile every shader instead of loading cached program binaries")
+            ("benchmark-glyphs", "Time atlas against bit-packed glyph lookups at 4K offscreen and exit")
             ("f,font", "Font profile", cxxopts::value<std::string>())
+            ("shader", "Shader to start with, e.g. ascii_matrix or cell/ascii", cxxopts::value<std::string>())
+            ("s,source", "Frame source (camera, video, images, replay, synthetic)", cxxopts::value<std::string>())
+            ("source-path", "Video file, image directory or recording for the video/images/replay sources", cxxopts::value<std::string>())
+            ("source-fps", "Playback rate for video/images/replay/synthetic sources", cxxopts::value<double>())
+            ("unpaced", "Produce file and synthetic frames as fast as possible")
+            ("motion", "Synthetic pattern speed (0 for a static frame)", cxxopts::value<float>())
+            ("record", "Record the first source's frames to this file for --source replay", cxxopts::value<std::string>())
+            ("static-tolerance", "Change threshold for skipping static frames, in 8-bit levels (0 disables)", cxxopts::value<float>())
+            ("vsync", "Swap interval: on, off or adaptive", cxxopts::value<std::string>())
+            ("max-fps", "Frame rate cap (0 leaves pacing to vsync)", cxxopts::value<double>())
+            ("low-latency", "Acquire frames just before they are drawn instead of right after the last swap")
+            ("latency-log", "Write every frame's capture-to-present timeline to this CSV file", cxxopts::value<std::string>())
+            ("latency-report", "Seconds between latency summaries (0 prints only on exit)", cxxopts::value<double>())
+            ("no-gpu-timers", "Don't time the render passes with GPU timer queries")
             ("help", "Print help");
 
         auto result = options.parse(argc, argv);
@@ -69,9 +171,51 @@ static void parse_from_args(int argc, char* argv[], AppConfig& config) {
             exit(0);
         }
         
-        if (result.count("device")) config.cameraDeviceID = result["device"].as<int>();
-        if (result.count("width")) config.cameraWidth = result["width"].as<int>();
-        if (result.count("height")) config.cameraHeight = result["height"].as<int>();
+        if (result.count("device")) config.camera.deviceID = result["device"].as<int>();
+        if (result.count("width")) config.camera.width = result["width"].as<int>();
+        if (result.count("height")) config.camera.height = result["height"].as<int>();
+        if (result.count("backend")) config.camera.backend = result["backend"].as<std::string>();
+        if (result.count("device-path")) config.camera.devicePath = result["device-path"].as<std::string>();
+        if (result.count("fps")) config.camera.fps = result["fps"].as<double>();
+        if (result.count("format")) config.camera.pixelFormat = result["format"].as<std::string>();
+        if (result.count("list-modes")) config.listModes = true;
+        if (result.count("cameras")) {
+            const auto deviceIDs = result["cameras"].as<std::vector<int>>();
+            config.extraCameraOverrides.clear();
+            for (size_t i = 0; i < deviceIDs.size(); ++i) {
+                if (i == 0) {
+                    config.camera.deviceID = deviceIDs[i];
+                    config.camera.devicePath.clear();
+                } else {
+                    config.extraCameraOverrides[static_cast<int>(i)]["device"] = std::to_string(deviceIDs[i]);
+                }
+            }
+        }
+        if (result.count("layout")) config.layout.mode = result["layout"].as<std::string>();
+        if (result.count("source")) config.source.type = result["source"].as<std::string>();
+        if (result.count("source-path")) config.source.path = result["source-path"].as<std::string>();
+        if (result.count("source-fps")) config.source.fps = result["source-fps"].as<double>();
+        if (result.count("upload-buffers")) config.render.uploadBuffers = result["upload-buffers"].as<int>();
+        if (result.count("no-persistent-mapping")) config.render.persistentMapping = false;
+        if (result.count("cell-grid")) config.render.cellGrid = result["cell-grid"].as<std::string>();
+        if (result.count("glyph-bits")) config.render.glyphBits = true;
+        if (result.count("render-width")) config.render.renderWidth = result["render-width"].as<int>();
+        if (result.count("render-height")) config.render.renderHeight = result["render-height"].as<int>();
+        if (result.count("snap-to-cells")) config.render.snapToCells = true;
+        if (result.count("upscale")) config.render.upscale = result["upscale"].as<std::string>();
+        if (result.count("no-shader-cache")) config.render.shaderCache = false;
+        if (result.count("benchmark-glyphs")) config.glyphBenchmark = true;
+        if (result.count("unpaced")) config.source.paced = false;
+        if (result.count("motion")) config.source.motion = result["motion"].as<float>();
+        if (result.count("record")) config.source.recordPath = result["record"].as<std::string>();
+        if (result.count("static-tolerance")) config.source.staticTolerance = result["static-tolerance"].as<float>();
+        if (result.count("vsync")) config.pacing.vsync = result["vsync"].as<std::string>();
+        if (result.count("max-fps")) config.pacing.maxFps = result["max-fps"].as<double>();
+        if (result.count("low-latency")) config.pacing.lowLatency = true;
+        if (result.count("latency-log")) config.stats.latencyLogPath = result["latency-log"].as<std::string>();
+        if (result.count("no-gpu-timers")) config.stats.gpuTimers = false;
+        if (result.count("latency-report")) config.stats.latencyReportSeconds = result["latency-report"].as<double>();
+        if (result.count("shader")) config.selectedShader = result["shader"].as<std::string>();
         if (result.count("font")) config.selectedFontProfile = result["font"].as<std::string>(); // ## MODIFIED ##
 
 
@@ -88,3 +232,20 @@ AppConfig load_configuration(int argc, char* argv[]) {
     parse_from_args(argc, argv, config); // Override with command-line args
     return config;
 }
+
+std::vector<CameraSettings> camera_settings_list(const AppConfig& config) {
+    std::vector<CameraSettings> cameras = { config.camera };
+    for (const auto& [index, overrides] : config.extraCameraOverrides) {
+        CameraSettings camera = config.camera;
+        // A different device number means a different node unless the
+        // section names one explicitly.
+        if (overrides.count("device") && !overrides.count("device_path")) {
+            camera.devicePath.clear();
+        }
+        for (const auto& [name, value] : overrides) {
+            apply_camera_setting(camera, name.c_str(), value.c_str());
+        }
+        cameras.push_back(camera);
+    }
+    return cameras;
+}
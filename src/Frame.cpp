@@ -0,0 +1,16 @@
+#include "Frame.h"
+#include <opencv2/imgproc.hpp>
+
+const cv::Mat& Frame::toBGR(cv::Mat& scratch) const {
+    switch (format) {
+    case PixelFormat::YUYV:
+        cv::cvtColor(image, scratch, cv::COLOR_YUV2BGR_YUYV);
+        return scratch;
+    case PixelFormat::NV12:
+        cv::cvtColor(image, scratch, cv::COLOR_YUV2BGR_NV12);
+        return scratch;
+    case PixelFormat::BGR:
+    default:
+        return image;
+    }
+}
@@ -0,0 +1,69 @@
+#include "FramePacer.h"
+#include "Frame.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+// Sleeps end this far ahead of a deadline; the rest is spun. Covers the
+// usual 1 ms timer slack on Linux with room to spare.
+constexpr int64_t kSpinNs = 2000000;
+// Headroom low-latency mode leaves between the planned end of the work and
+// the present, for the swap call and jitter in the work itself.
+constexpr int64_t kLowLatencyMarginNs = 1500000;
+} // namespace
+
+FramePacer::FramePacer(double maxFps, bool lowLatency, double refreshHz)
+    : capped(maxFps > 0.0), lowLatency(lowLatency) {
+    if (capped) {
+        intervalNs = static_cast<int64_t>(1e9 / maxFps);
+    } else if (lowLatency && refreshHz > 0.0) {
+        intervalNs = static_cast<int64_t>(1e9 / refreshHz);
+    }
+}
+
+void FramePacer::waitUntil(int64_t deadlineNs) {
+    int64_t remaining = deadlineNs - steadyClockNs();
+    if (remaining > kSpinNs) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - kSpinNs));
+    }
+    while (steadyClockNs() < deadlineNs) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::waitForNextFrame(int64_t swapNs) {
+    if (intervalNs == 0) {
+        return;
+    }
+    int64_t startNs;
+    if (lowLatency) {
+        // Under vsync alone the swap returned at a vertical blank, so the
+        // next present is an interval later; under a cap presents keep to
+        // their own cadence. Either way a late frame restarts the cadence
+        // rather than trying to catch up.
+        nextPresentNs = capped && nextPresentNs != 0 ? nextPresentNs + intervalNs : swapNs + intervalNs;
+        if (nextPresentNs <= swapNs) {
+            nextPresentNs = swapNs + intervalNs;
+        }
+        startNs = nextPresentNs - plannedWorkNs();
+    } else {
+        startNs = lastStartNs + intervalNs;
+    }
+    const int64_t now = steadyClockNs();
+    if (startNs > now) {
+        waitUntil(startNs);
+    } else {
+        startNs = now;
+    }
+    lastStartNs = startNs;
+}
+
+void FramePacer::recordWork(int64_t startNs, int64_t endNs) {
+    workNs[nextWork] = std::max<int64_t>(endNs - startNs, 0);
+    nextWork = (nextWork + 1) % kWorkHistory;
+}
+
+int64_t FramePacer::plannedWorkNs() const {
+    return *std::max_element(workNs.begin(), workNs.end()) + kLowLatencyMarginNs;
+}
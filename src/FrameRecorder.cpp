@@ -0,0 +1,150 @@
+#include "FrameRecorder.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::open(const std::string& path) {
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "ERROR: Could not create recording '" << path << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    filePath = path;
+
+    // Written again with the index offset on close.
+    recording::FileHeader header{};
+    std::memcpy(header.magic, recording::kFileMagic, sizeof(header.magic));
+    header.version = recording::kVersion;
+    header.headerBytes = sizeof(header);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::cerr << "ERROR: Could not write recording '" << path << "'." << std::endl;
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    writeOffset = sizeof(header);
+
+    std::cout << "Recording frames to " << path << std::endl;
+    writerThread = std::thread(&FrameRecorder::writerLoop, this);
+    return true;
+}
+
+void FrameRecorder::append(const Frame& frame) {
+    if (frame.image.empty()) {
+        return;
+    }
+    Pending chunk;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing || !file) {
+            return;
+        }
+        if (pending.size() >= kMaxPending) {
+            ++droppedFrames;
+            return;
+        }
+        if (!freeBuffers.empty()) {
+            chunk = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+
+    // Store rows tightly packed; driver buffers may have padded strides.
+    const size_t rowBytes = static_cast<size_t>(frame.image.cols) * frame.image.elemSize();
+    chunk.header = {};
+    chunk.header.magic = recording::kFrameMagic;
+    chunk.header.headerBytes = sizeof(recording::ChunkHeader);
+    chunk.header.payloadBytes = rowBytes * frame.image.rows;
+    chunk.header.timestampNs = frame.timestampNs;
+    chunk.header.sequence = frame.sequence;
+    chunk.header.pixelFormat = static_cast<int32_t>(frame.format);
+    chunk.header.cvType = frame.image.type();
+    chunk.header.rows = frame.image.rows;
+    chunk.header.cols = frame.image.cols;
+    chunk.pixels.resize(chunk.header.payloadBytes);
+    for (int y = 0; y < frame.image.rows; ++y) {
+        std::memcpy(chunk.pixels.data() + rowBytes * y, frame.image.ptr<uint8_t>(y), rowBytes);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(chunk));
+    }
+    wake.notify_one();
+}
+
+void FrameRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return closing || !pending.empty(); });
+        if (pending.empty()) {
+            break; // Closing and drained
+        }
+        Pending chunk = std::move(pending.front());
+        pending.pop_front();
+
+        lock.unlock();
+        if (!writeFailed && !writeChunk(chunk)) {
+            std::cerr << "ERROR: Writing recording '" << filePath << "' failed: " << std::strerror(errno)
+                      << ". Recording stopped." << std::endl;
+            writeFailed = true;
+        }
+        lock.lock();
+        freeBuffers.push_back(std::move(chunk));
+    }
+}
+
+bool FrameRecorder::writeChunk(const Pending& chunk) {
+    static const uint8_t padding[recording::kAlignment] = {};
+    const uint64_t chunkOffset = writeOffset;
+    const uint64_t payloadEnd = chunkOffset + sizeof(chunk.header) + chunk.pixels.size();
+    const size_t paddingBytes = static_cast<size_t>(recording::alignUp(payloadEnd) - payloadEnd);
+    if (std::fwrite(&chunk.header, sizeof(chunk.header), 1, file) != 1 ||
+        std::fwrite(chunk.pixels.data(), 1, chunk.pixels.size(), file) != chunk.pixels.size() ||
+        std::fwrite(padding, 1, paddingBytes, file) != paddingBytes) {
+        return false;
+    }
+    writeOffset = payloadEnd + paddingBytes;
+    index.push_back({chunkOffset, chunk.header.timestampNs});
+    return true;
+}
+
+void FrameRecorder::close() {
+    if (!writerThread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    wake.notify_one();
+    writerThread.join();
+
+    recording::ChunkHeader indexHeader{};
+    indexHeader.magic = recording::kIndexMagic;
+    indexHeader.headerBytes = sizeof(indexHeader);
+    indexHeader.payloadBytes = index.size() * sizeof(recording::IndexEntry);
+
+    recording::FileHeader header{};
+    std::memcpy(header.magic, recording::kFileMagic, sizeof(header.magic));
+    header.version = recording::kVersion;
+    header.headerBytes = sizeof(header);
+    header.frameCount = index.size();
+    header.indexOffset = writeOffset;
+
+    bool ok = !writeFailed && std::fwrite(&indexHeader, sizeof(indexHeader), 1, file) == 1 &&
+              std::fwrite(index.data(), sizeof(recording::IndexEntry), index.size(), file) == index.size() &&
+              std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        std::cerr << "Warning: Could not finish the index of recording '" << filePath
+                  << "'; replay will scan it instead." << std::endl;
+    }
+    std::cout << "Recording closed: " << index.size() << " frames written to " << filePath << ", "
+              << droppedFrames << " dropped." << std::endl;
+}
@@ -0,0 +1,77 @@
+#include "FrameSource.h"
+#include "Camera.h"
+#include "ImageSequenceSource.h"
+#include "RecordingSource.h"
+#include "SyntheticSource.h"
+#include "VideoFileSource.h"
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+bool FrameSource::waitForFrame(Frame& frame) {
+    while (!read(frame)) {
+        if (!isRunning()) {
+            return read(frame);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+std::unique_ptr<FrameSource> FrameSource::create(const AppConfig& config) {
+    const SourceSettings& source = config.source;
+    if (source.type == "video") {
+        return std::make_unique<VideoFileSource>(source);
+    }
+    if (source.type == "images") {
+        return std::make_unique<ImageSequenceSource>(source);
+    }
+    if (source.type == "replay") {
+        return std::make_unique<RecordingSource>(source);
+    }
+    if (source.type == "synthetic") {
+        return std::make_unique<SyntheticSource>(config.camera.width, config.camera.height, source);
+    }
+    if (source.type != "camera") {
+        std::cerr << "Warning: Unknown frame source '" << source.type << "'. Using camera." << std::endl;
+    }
+    return std::make_unique<Camera>(config.camera);
+}
+
+std::vector<std::unique_ptr<FrameSource>> FrameSource::createAll(const AppConfig& config, size_t maxSources) {
+    std::vector<std::unique_ptr<FrameSource>> sources;
+    std::vector<CameraSettings> cameras = camera_settings_list(config);
+    if (config.source.type != "camera" || cameras.size() == 1) {
+        if (cameras.size() > 1) {
+            std::cerr << "Warning: Extra cameras are ignored by the '" << config.source.type << "' source." << std::endl;
+        }
+        sources.push_back(create(config));
+        return sources;
+    }
+
+    if (cameras.size() > maxSources) {
+        std::cerr << "Warning: " << cameras.size() << " cameras configured, using the first " << maxSources << "." << std::endl;
+        cameras.resize(maxSources);
+    }
+    // Share the cores between the cameras' MJPEG decoder pools instead of
+    // giving each one a full pool.
+    int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int threadsPerCamera = std::clamp(cores / static_cast<int>(cameras.size()), 1, 4);
+    for (CameraSettings& camera : cameras) {
+        if (camera.decodeThreads <= 0) {
+            camera.decodeThreads = threadsPerCamera;
+        }
+        // The cameras share one texture array, so extra cameras left on
+        // "auto" follow whatever format the first one negotiated.
+        if (!sources.empty() && camera.backend == "v4l2" && camera.pixelFormat == "auto") {
+            switch (sources[0]->getPixelFormat()) {
+            case PixelFormat::YUYV: camera.pixelFormat = "yuyv"; break;
+            case PixelFormat::NV12: camera.pixelFormat = "nv12"; break;
+            default: camera.pixelFormat = "mjpeg"; break; // Decoded to BGR
+            }
+        }
+        sources.push_back(std::make_unique<Camera>(camera));
+    }
+    return sources;
+}
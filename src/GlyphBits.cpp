@@ -0,0 +1,35 @@
+#include "GlyphBits.h"
+#include <algorithm>
+
+int GlyphBits::wordsPerGlyph(int charWidth, int charHeight) {
+    return (std::max(0, charWidth) * std::max(0, charHeight) + 31) / 32;
+}
+
+std::vector<uint32_t> GlyphBits::pack(const cv::Mat& atlas, int charWidth, int charHeight, int numChars,
+                                      int threshold) {
+    const int words = wordsPerGlyph(charWidth, charHeight);
+    std::vector<uint32_t> bits(static_cast<size_t>(std::max(0, numChars)) * words, 0u);
+    if (atlas.empty() || atlas.depth() != CV_8U || (atlas.channels() != 1 && atlas.channels() < 3)) {
+        return bits;
+    }
+
+    // BGR(A) images keep red at index 2.
+    const int channels = atlas.channels();
+    const int red = channels == 1 ? 0 : 2;
+    const int rows = std::min(charHeight, atlas.rows);
+    for (int glyph = 0; glyph < numChars; ++glyph) {
+        uint32_t* glyphWords = &bits[static_cast<size_t>(glyph) * words];
+        const int x0 = glyph * charWidth;
+        const int columns = std::min(charWidth, atlas.cols - x0);
+        for (int y = 0; y < rows; ++y) {
+            const uint8_t* row = atlas.ptr<uint8_t>(y);
+            for (int x = 0; x < columns; ++x) {
+                if (row[(x0 + x) * channels + red] >= threshold) {
+                    const int bit = y * charWidth + x;
+                    glyphWords[bit / 32] |= 1u << (bit % 32);
+                }
+            }
+        }
+    }
+    return bits;
+}
@@ -0,0 +1,94 @@
+#include "GpuProfiler.h"
+
+namespace {
+// Workaround for Mesa's llvmpipe, which sometimes reports thousands of
+// seconds for a query that saw no rendering and would wreck the
+// percentiles. This is not a budget for real passes; the cut-off only has
+// to sit between any genuine result and that garbage.
+constexpr GLuint64 kMaxPlausibleNs = 1000000000;
+} // namespace
+
+GpuProfiler::GpuProfiler(LatencyTracker& tracker, bool enabled) : tracker(tracker), enabled(enabled) {
+    if (!enabled) {
+        return;
+    }
+    for (FrameQueries& frame : frames) {
+        for (auto& spans : frame.queries) {
+            glGenQueries(kMaxSpans, spans.data());
+        }
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (!enabled) {
+        return;
+    }
+    for (FrameQueries& frame : frames) {
+        for (auto& spans : frame.queries) {
+            glDeleteQueries(kMaxSpans, spans.data());
+        }
+    }
+}
+
+void GpuProfiler::beginFrame(const std::string& shaderName) {
+    if (!enabled) {
+        return;
+    }
+    if (activePass >= 0) {
+        end(static_cast<LatencyTracker::GpuPass>(activePass));
+    }
+    currentFrame = (currentFrame + 1) % kFramesInFlight;
+    FrameQueries& frame = frames[currentFrame];
+    collect(frame);
+    frame.shaderName = shaderName;
+}
+
+void GpuProfiler::collect(FrameQueries& frame) {
+    for (int pass = 0; pass < LatencyTracker::GpuPassCount; ++pass) {
+        const int spans = frame.spans[pass];
+        const bool overflowed = frame.overflowed[pass];
+        frame.spans[pass] = 0;
+        frame.overflowed[pass] = false;
+        if (spans == 0) {
+            continue;
+        }
+        GLuint64 totalNs = 0;
+        bool complete = !overflowed;
+        for (int span = 0; span < spans && complete; ++span) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(frame.queries[pass][span], GL_QUERY_RESULT_AVAILABLE, &available);
+            GLuint64 elapsedNs = 0;
+            if (available) {
+                glGetQueryObjectui64v(frame.queries[pass][span], GL_QUERY_RESULT, &elapsedNs);
+            }
+            complete = available && elapsedNs <= kMaxPlausibleNs;
+            totalNs += elapsedNs;
+        }
+        if (!complete) {
+            ++droppedResults;
+            continue;
+        }
+        tracker.recordGpu(frame.shaderName, static_cast<LatencyTracker::GpuPass>(pass), static_cast<int64_t>(totalNs));
+    }
+}
+
+void GpuProfiler::begin(LatencyTracker::GpuPass pass) {
+    if (!enabled || currentFrame < 0 || activePass >= 0) {
+        return;
+    }
+    FrameQueries& frame = frames[currentFrame];
+    if (frame.spans[pass] == kMaxSpans) {
+        frame.overflowed[pass] = true;
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[pass][frame.spans[pass]++]);
+    activePass = pass;
+}
+
+void GpuProfiler::end(LatencyTracker::GpuPass pass) {
+    if (activePass != pass) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    activePass = -1;
+}
@@ -0,0 +1,94 @@
+#include "ImageSequenceSource.h"
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include <opencv2/imgcodecs.hpp>
+
+namespace {
+bool isImageFile(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tif" || ext == ".tiff";
+}
+} // namespace
+
+ImageSequenceSource::ImageSequenceSource(const SourceSettings& settings)
+    : prefetchDepth(static_cast<size_t>(std::max(1, settings.prefetch))) {
+    try {
+        for (const auto& entry : std::filesystem::directory_iterator(settings.path)) {
+            if (entry.is_regular_file() && isImageFile(entry.path())) {
+                imagePaths.push_back(entry.path().string());
+            }
+        }
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::cerr << "ERROR: Could not read image directory '" << settings.path << "': " << e.what() << std::endl;
+        return;
+    }
+    if (imagePaths.empty()) {
+        std::cerr << "ERROR: No images found in '" << settings.path << "'." << std::endl;
+        return;
+    }
+    std::sort(imagePaths.begin(), imagePaths.end());
+
+    cv::Mat first = cv::imread(imagePaths.front(), cv::IMREAD_COLOR);
+    if (first.empty()) {
+        std::cerr << "ERROR: Could not decode '" << imagePaths.front() << "'." << std::endl;
+        imagePaths.clear();
+        return;
+    }
+    frameWidth = first.cols;
+    frameHeight = first.rows;
+
+    double fps = settings.fps > 0.0 ? settings.fps : 30.0;
+    std::cout << "Image sequence " << settings.path << ": " << imagePaths.size() << " images, "
+              << frameWidth << "x" << frameHeight << ", prefetching " << prefetchDepth << std::endl;
+
+    fillPrefetchQueue();
+    start(settings.paced ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / fps))
+                         : std::chrono::nanoseconds::zero());
+}
+
+ImageSequenceSource::~ImageSequenceSource() {
+    stop();
+}
+
+void ImageSequenceSource::fillPrefetchQueue() {
+    while (prefetched.size() < prefetchDepth) {
+        const std::string& path = imagePaths[nextToLoad];
+        nextToLoad = (nextToLoad + 1) % imagePaths.size();
+        prefetched.push_back(std::async(std::launch::async, [path] {
+            return cv::imread(path, cv::IMREAD_COLOR);
+        }));
+    }
+}
+
+bool ImageSequenceSource::produce(Frame& frame) {
+    // Skip over images that fail to decode, but give up after a full lap.
+    for (size_t attempt = 0; attempt < imagePaths.size(); ++attempt) {
+        cv::Mat image = prefetched.front().get();
+        prefetched.pop_front();
+        fillPrefetchQueue();
+        if (image.empty()) {
+            continue;
+        }
+
+        frame.image = image;
+        frame.format = PixelFormat::BGR;
+        frame.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        return true;
+    }
+    return false;
+}
+
+bool ImageSequenceSource::isOpened() const {
+    return !imagePaths.empty();
+}
+
+int ImageSequenceSource::getWidth() const {
+    return frameWidth;
+}
+
+int ImageSequenceSource::getHeight() const {
+    return frameHeight;
+}
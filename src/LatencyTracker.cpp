@@ -0,0 +1,208 @@
+#include "LatencyTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+FrameTimeline FrameTimeline::begin(const Frame& frame, int source) {
+    FrameTimeline timeline;
+    timeline.source = source;
+    timeline.sequence = frame.sequence;
+    timeline.captureNs = frame.timestampNs;
+    timeline.dequeueNs = frame.dequeueNs;
+    timeline.acquireNs = steadyClockNs();
+    return timeline;
+}
+
+LatencyTracker::LatencyTracker(const StatsSettings& settings)
+    : reportIntervalNs(static_cast<int64_t>(settings.latencyReportSeconds * 1e9)) {
+    for (Window& window : windows) {
+        window.samples.reserve(kWindowSize);
+    }
+    lastReportNs = steadyClockNs();
+
+    if (!settings.latencyLogPath.empty()) {
+        log.open(settings.latencyLogPath, std::ios::out | std::ios::trunc);
+        if (!log.is_open()) {
+            std::cerr << "Warning: Could not open latency log '" << settings.latencyLogPath << "'." << std::endl;
+        } else {
+            log << "source,sequence,capture_ns,dequeue_ns,acquire_ns,upload_ns,inference_start_ns,"
+                   "inference_end_ns,draw_submit_ns,swap_ns\n";
+            std::cout << "Logging per-frame latency to " << settings.latencyLogPath << std::endl;
+        }
+    }
+}
+
+LatencyTracker::~LatencyTracker() {
+    if (recordedFrames > 0) {
+        printSummary();
+    }
+}
+
+void LatencyTracker::record(const FrameTimeline& t) {
+    addSample(Capture, t.captureNs, t.dequeueNs);
+    addSample(Queue, t.dequeueNs, t.acquireNs);
+    addSample(Upload, t.acquireNs, t.uploadNs);
+    addSample(Inference, t.inferenceStartNs, t.inferenceEndNs);
+    addSample(Draw, std::max({t.acquireNs, t.uploadNs, t.inferenceEndNs}), t.drawSubmitNs);
+    addSample(Present, t.drawSubmitNs, t.swapNs);
+    addSample(Total, t.captureNs, t.swapNs);
+    ++recordedFrames;
+
+    if (log.is_open()) {
+        log << t.source << ',' << t.sequence << ',' << t.captureNs << ',' << t.dequeueNs << ',' << t.acquireNs << ','
+            << t.uploadNs << ',' << t.inferenceStartNs << ',' << t.inferenceEndNs << ','
+            << t.drawSubmitNs << ',' << t.swapNs << '\n';
+    }
+
+    if (reportIntervalNs > 0 && t.swapNs - lastReportNs >= reportIntervalNs) {
+        printSummary();
+        lastReportNs = t.swapNs;
+    }
+}
+
+void LatencyTracker::addSample(Stage stage, int64_t fromNs, int64_t toNs) {
+    // Either end missing means the stage was skipped for this frame.
+    if (fromNs == 0 || toNs == 0) {
+        return;
+    }
+    ++sampleCounts[stage];
+    push(windows[stage], std::max<int64_t>(toNs - fromNs, 0));
+}
+
+void LatencyTracker::push(Window& window, int64_t sample) {
+    if (window.samples.size() < kWindowSize) {
+        window.samples.push_back(sample);
+    } else {
+        window.samples[window.next] = sample;
+    }
+    window.next = (window.next + 1) % kWindowSize;
+}
+
+void LatencyTracker::recordPresent(int64_t swapNs) {
+    if (lastSwapNs != 0) {
+        push(presentIntervals, std::max<int64_t>(swapNs - lastSwapNs, 0));
+    }
+    lastSwapNs = swapNs;
+}
+
+void LatencyTracker::recordGpu(const std::string& shaderName, GpuPass pass, int64_t ns) {
+    push(gpuWindows[shaderName][pass], ns);
+}
+
+void LatencyTracker::getFrameTimeStats(double& mean, double& deviation) const {
+    mean = 0.0;
+    deviation = 0.0;
+    const std::vector<int64_t>& samples = presentIntervals.samples;
+    if (samples.empty()) {
+        return;
+    }
+    for (int64_t sample : samples) {
+        mean += static_cast<double>(sample);
+    }
+    mean /= static_cast<double>(samples.size());
+    for (int64_t sample : samples) {
+        deviation += (static_cast<double>(sample) - mean) * (static_cast<double>(sample) - mean);
+    }
+    deviation = std::sqrt(deviation / static_cast<double>(samples.size())) / 1e6;
+    mean /= 1e6;
+}
+
+void LatencyTracker::recordSkip(Stage stage) {
+    ++skipCounts[stage];
+}
+
+LatencyTracker::Percentiles LatencyTracker::getPercentiles(Stage stage) const {
+    return percentilesOf(windows[stage]);
+}
+
+LatencyTracker::Percentiles LatencyTracker::percentilesOf(const Window& window) {
+    Percentiles result;
+    std::vector<int64_t> sorted = window.samples;
+    result.samples = sorted.size();
+    if (sorted.empty()) {
+        return result;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&](double quantile) {
+        size_t index = static_cast<size_t>(quantile * static_cast<double>(sorted.size() - 1) + 0.5);
+        return static_cast<double>(sorted[index]) / 1e6;
+    };
+    result.p50 = at(0.50);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    return result;
+}
+
+const char* LatencyTracker::stageName(Stage stage) {
+    switch (stage) {
+        case Capture: return "capture";
+        case Queue: return "queue";
+        case Upload: return "upload";
+        case Inference: return "inference";
+        case Draw: return "draw";
+        case Present: return "present";
+        case Total: return "total";
+        default: return "?";
+    }
+}
+
+const char* LatencyTracker::gpuPassName(GpuPass pass) {
+    switch (pass) {
+        case GpuUpload: return "upload";
+        case GpuCellGrid: return "cell grid";
+        case GpuMask: return "mask upload";
+        case GpuCells: return "cell pass";
+        case GpuDraw: return "draw";
+        case GpuBlit: return "blit";
+        default: return "?";
+    }
+}
+
+void LatencyTracker::printSummary() const {
+    char line[128];
+    std::snprintf(line, sizeof(line), "Latency, last %zu frames (ms)", windows[Total].samples.size());
+    std::snprintf(line, sizeof(line), "%-34s %8s %8s %8s %8s", std::string(line).c_str(), "p50", "p95", "p99", "skipped");
+    std::cout << line << std::endl;
+    for (int i = 0; i < StageCount; ++i) {
+        Stage stage = static_cast<Stage>(i);
+        Percentiles p = getPercentiles(stage);
+        if (p.samples == 0 && skipCounts[stage] == 0) {
+            continue;
+        }
+        // Skip rate over the whole run, not just the window.
+        uint64_t attempts = sampleCounts[stage] + skipCounts[stage];
+        double skipped = attempts ? 100.0 * static_cast<double>(skipCounts[stage]) / static_cast<double>(attempts) : 0.0;
+        std::snprintf(line, sizeof(line), "  %-32s %8.2f %8.2f %8.2f %7.1f%%", stageName(stage), p.p50, p.p95, p.p99, skipped);
+        std::cout << line << std::endl;
+    }
+
+    // Swap to swap, whether or not a new camera frame was shown; the
+    // deviation is the jitter a pacing mode leaves. "total" above is the
+    // capture-to-present (input-to-photon, less scanout) latency.
+    Percentiles frameTime = percentilesOf(presentIntervals);
+    if (frameTime.samples > 0) {
+        double mean = 0.0;
+        double deviation = 0.0;
+        getFrameTimeStats(mean, deviation);
+        std::snprintf(line, sizeof(line), "  %-32s %8.2f %8.2f %8.2f  mean %.2f, sd %.2f", "frame time", frameTime.p50,
+                      frameTime.p95, frameTime.p99, mean, deviation);
+        std::cout << line << std::endl;
+    }
+
+    // GPU time of each pass, by the shader that was active; a pass only
+    // counts frames it ran in.
+    for (const auto& entry : gpuWindows) {
+        std::snprintf(line, sizeof(line), "GPU, %s (ms)", entry.first.c_str());
+        std::cout << line << std::endl;
+        for (int i = 0; i < GpuPassCount; ++i) {
+            Percentiles p = percentilesOf(entry.second[i]);
+            if (p.samples == 0) {
+                continue;
+            }
+            std::snprintf(line, sizeof(line), "  %-32s %8.2f %8.2f %8.2f", gpuPassName(static_cast<GpuPass>(i)), p.p50,
+                          p.p95, p.p99);
+            std::cout << line << std::endl;
+        }
+    }
+}
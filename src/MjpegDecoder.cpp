@@ -0,0 +1,217 @@
+#include "MjpegDecoder.h"
+#include <iostream>
+#include <algorithm>
+#include <csetjmp>
+#include <cstring>
+#include <cstdio>
+#include <jpeglib.h>
+
+namespace {
+// libjpeg reports fatal errors through error_exit, which by default calls
+// exit(). Jump back into the decoder instead so a corrupt frame is skipped.
+struct JpegErrorManager {
+    jpeg_error_mgr pub;
+    std::jmp_buf jumpBuffer;
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+    auto* err = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+    std::longjmp(err->jumpBuffer, 1);
+}
+
+void jpegOutputMessage(j_common_ptr) {
+    // Truncated frames are common on USB cameras; don't spam the console.
+}
+
+// The coarsest 1/N IDCT scale whose output still covers the minimum size.
+// Scaling in the DCT domain skips most of the IDCT and colour conversion work,
+// and averages each block rather than point sampling it.
+int pickScaleDenom(int width, int height, int minWidth, int minHeight) {
+    for (int denom : {8, 4, 2}) {
+        if ((width + denom - 1) / denom >= minWidth && (height + denom - 1) / denom >= minHeight) {
+            return denom;
+        }
+    }
+    return 1;
+}
+
+// Decodes `data` into `output` as BGR, reusing its buffer when the size matches.
+bool decodeJpeg(jpeg_decompress_struct& cinfo, JpegErrorManager& err,
+                const uint8_t* data, size_t size, int minWidth, int minHeight, cv::Mat& output) {
+    if (setjmp(err.jumpBuffer)) {
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+
+    jpeg_mem_src(&cinfo, data, static_cast<unsigned long>(size));
+    if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        jpeg_abort_decompress(&cinfo);
+        return false;
+    }
+    cinfo.out_color_space = JCS_EXT_BGR;
+    cinfo.dct_method = JDCT_ISLOW;
+    if (minWidth > 0 && minHeight > 0) {
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = pickScaleDenom(static_cast<int>(cinfo.image_width), static_cast<int>(cinfo.image_height),
+                                           minWidth, minHeight);
+    }
+    jpeg_start_decompress(&cinfo);
+
+    output.create(static_cast<int>(cinfo.output_height), static_cast<int>(cinfo.output_width), CV_8UC3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = output.ptr<JSAMPLE>(static_cast<int>(cinfo.output_scanline));
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    return true;
+}
+} // namespace
+
+MjpegDecoder::MjpegDecoder(int threadCount) {
+    threadCount = std::max(1, threadCount);
+    // One slot per worker plus headroom so the producer can queue the next
+    // frame while every worker is busy and the consumer holds the oldest.
+    jobs.resize(threadCount + 2);
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&MjpegDecoder::workerLoop, this);
+    }
+    std::cout << "MJPEG decoder started with " << threadCount << " worker threads." << std::endl;
+}
+
+MjpegDecoder::~MjpegDecoder() {
+    stop();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+void MjpegDecoder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    jobFinished.notify_all();
+}
+
+bool MjpegDecoder::submit(const uint8_t* data, size_t size, int64_t timestampNs) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = std::find_if(jobs.begin(), jobs.end(), [](const Job& job) { return job.state == JobState::Free; });
+    if (it == jobs.end()) {
+        ++droppedFrames;
+        return false;
+    }
+    Job& job = *it;
+    job.state = JobState::Filling;
+    job.sequence = nextSubmitSequence++;
+    job.timestampNs = timestampNs;
+    lock.unlock();
+
+    // Nobody else touches a Filling slot, so copy outside the lock. Buffers
+    // only ever grow, so steady state allocates nothing.
+    if (job.compressed.size() < size) {
+        job.compressed.resize(size);
+    }
+    std::memcpy(job.compressed.data(), data, size);
+    job.compressedSize = size;
+
+    lock.lock();
+    job.state = JobState::Queued;
+    lock.unlock();
+    workAvailable.notify_one();
+    return true;
+}
+
+void MjpegDecoder::workerLoop() {
+    jpeg_decompress_struct cinfo{};
+    JpegErrorManager err{};
+    cinfo.err = jpeg_std_error(&err.pub);
+    err.pub.error_exit = jpegErrorExit;
+    err.pub.output_message = jpegOutputMessage;
+    jpeg_create_decompress(&cinfo);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        // Always take the oldest queued frame so delivery order is never held up.
+        Job* job = nullptr;
+        workAvailable.wait(lock, [&] {
+            if (stopping) return true;
+            for (Job& candidate : jobs) {
+                if (candidate.state == JobState::Queued && (!job || candidate.sequence < job->sequence)) {
+                    job = &candidate;
+                }
+            }
+            return job != nullptr;
+        });
+        if (stopping) break;
+
+        job->state = JobState::Decoding;
+        lock.unlock();
+        bool ok = decodeJpeg(cinfo, err, job->compressed.data(), job->compressedSize,
+                             minimumWidth.load(std::memory_order_relaxed),
+                             minimumHeight.load(std::memory_order_relaxed), job->decoded);
+        if (ok) {
+            int denom = static_cast<int>(cinfo.scale_denom);
+            if (activeScaleDenom.exchange(denom, std::memory_order_relaxed) != denom) {
+                std::cout << "MJPEG decoding at 1/" << denom << " scale ("
+                          << job->decoded.cols << "x" << job->decoded.rows << ")." << std::endl;
+            }
+        }
+        lock.lock();
+
+        job->state = ok ? JobState::Done : JobState::Failed;
+        jobFinished.notify_all();
+    }
+    lock.unlock();
+
+    jpeg_destroy_decompress(&cinfo);
+}
+
+bool MjpegDecoder::next(Frame& frame) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        Job* job = nullptr;
+        jobFinished.wait(lock, [&] {
+            if (stopping) return true;
+            for (Job& candidate : jobs) {
+                if (candidate.sequence == nextDeliverSequence &&
+                    (candidate.state == JobState::Done || candidate.state == JobState::Failed)) {
+                    job = &candidate;
+                    return true;
+                }
+            }
+            return false;
+        });
+        if (stopping) return false;
+
+        ++nextDeliverSequence;
+        if (job->state == JobState::Failed) {
+            ++corruptFrames;
+            job->state = JobState::Free;
+            continue;
+        }
+
+        // Trade buffers: the frame takes the decoded pixels and the job keeps
+        // the frame's old buffer to decode the next frame into.
+        std::swap(frame.image, job->decoded);
+        frame.format = PixelFormat::BGR;
+        frame.timestampNs = job->timestampNs;
+        job->state = JobState::Free;
+        return true;
+    }
+}
+
+void MjpegDecoder::setMinimumSize(int width, int height) {
+    minimumWidth = width;
+    minimumHeight = height;
+}
+
+uint64_t MjpegDecoder::getDroppedFrames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedFrames;
+}
+
+uint64_t MjpegDecoder::getCorruptFrames() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return corruptFrames;
+}
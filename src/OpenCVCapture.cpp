@@ -0,0 +1,68 @@
+#include "OpenCVCapture.h"
+#include "CameraModes.h"
+#include <iostream>
+#include <chrono>
+
+OpenCVCapture::OpenCVCapture(const CameraSettings& settings) {
+    // VideoCapture can't list modes, so ask the driver directly before
+    // VideoCapture takes the device.
+    CameraMode mode{fourccFromName(settings.pixelFormat), settings.width, settings.height, settings.fps};
+    {
+        std::unique_ptr<V4L2Device> device = V4L2Device::open(cameraDevicePath(settings));
+        if (device->isOpen()) {
+            chooseCameraMode(enumerateCameraModes(*device, settings), settings, mode);
+        }
+    }
+
+    cap.open(settings.deviceID, cv::CAP_V4L2);
+    if (!cap.isOpened()) {
+        std::cerr << "ERROR: Could not open camera." << std::endl;
+        return;
+    }
+
+    // The format has to be set before the size for the V4L2 backend to
+    // pick a matching mode. VideoCapture converts whatever arrives to BGR.
+    if (mode.fourcc != 0) {
+        cap.set(cv::CAP_PROP_FOURCC, static_cast<double>(mode.fourcc));
+    }
+    cap.set(cv::CAP_PROP_FRAME_WIDTH, mode.width);
+    cap.set(cv::CAP_PROP_FRAME_HEIGHT, mode.height);
+    if (mode.fps > 0.0) {
+        cap.set(cv::CAP_PROP_FPS, mode.fps);
+    }
+    cap.set(cv::CAP_PROP_BUFFERSIZE, settings.bufferCount);
+
+    frameWidth = cap.get(cv::CAP_PROP_FRAME_WIDTH);
+    frameHeight = cap.get(cv::CAP_PROP_FRAME_HEIGHT);
+    std::cout << "OpenCV capture: " << fourccToString(static_cast<uint32_t>(cap.get(cv::CAP_PROP_FOURCC))) << " "
+              << frameWidth << "x" << frameHeight << " at " << cap.get(cv::CAP_PROP_FPS) << " fps" << std::endl;
+}
+
+OpenCVCapture::~OpenCVCapture() {
+    if (cap.isOpened()) {
+        cap.release();
+    }
+}
+
+bool OpenCVCapture::isOpened() const {
+    return cap.isOpened();
+}
+
+bool OpenCVCapture::grab(Frame& frame) {
+    if (!cap.read(frame.image) || frame.image.empty()) {
+        return false;
+    }
+    frame.format = PixelFormat::BGR;
+    // VideoCapture hides the driver timestamp, so stamp the frame on arrival.
+    frame.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return true;
+}
+
+int OpenCVCapture::getWidth() const {
+    return frameWidth;
+}
+
+int OpenCVCapture::getHeight() const {
+    return frameHeight;
+}
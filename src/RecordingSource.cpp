@@ -0,0 +1,190 @@
+#include "RecordingSource.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+RecordingSource::RecordingSource(const SourceSettings& settings) {
+    if (!mapFile(settings.path)) {
+        return;
+    }
+    if (!readIndex() && !scanChunks()) {
+        return;
+    }
+
+    const recording::ChunkHeader* first = chunkAt(index.front().offset);
+    pixelFormat = static_cast<PixelFormat>(first->pixelFormat);
+    frameWidth = first->cols;
+    frameHeight = pixelFormat == PixelFormat::NV12 ? first->rows * 2 / 3 : first->rows;
+    firstTimestampNs = index.front().timestampNs;
+
+    // Recorded timing unless a fixed rate is asked for.
+    followTimestamps = settings.paced && settings.fps <= 0.0;
+    std::chrono::nanoseconds interval = std::chrono::nanoseconds::zero();
+    if (settings.paced && settings.fps > 0.0) {
+        interval = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / settings.fps));
+    }
+
+    double seconds = static_cast<double>(index.back().timestampNs - firstTimestampNs) / 1e9;
+    std::cout << "Recording " << settings.path << ": " << index.size() << " frames, " << frameWidth << "x"
+              << frameHeight << ", " << seconds << " s, "
+              << (followTimestamps ? "recorded timing" : settings.paced ? "fixed rate" : "unpaced") << std::endl;
+
+    playbackStart = std::chrono::steady_clock::now();
+    start(interval);
+}
+
+RecordingSource::~RecordingSource() {
+    stop();
+    if (mapped) {
+        ::munmap(const_cast<uint8_t*>(mapped), mappedBytes);
+    }
+}
+
+bool RecordingSource::mapFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "ERROR: Could not open recording '" << path << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat info{};
+    void* address = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(recording::FileHeader))) {
+        address = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // The mapping keeps the file alive
+    if (address == MAP_FAILED) {
+        std::cerr << "ERROR: Could not map recording '" << path << "'." << std::endl;
+        return false;
+    }
+    mapped = static_cast<const uint8_t*>(address);
+    mappedBytes = static_cast<size_t>(info.st_size);
+    // Playback walks the file front to back: read ahead aggressively.
+    ::madvise(address, mappedBytes, MADV_SEQUENTIAL);
+
+    const auto* header = reinterpret_cast<const recording::FileHeader*>(mapped);
+    if (std::memcmp(header->magic, recording::kFileMagic, sizeof(header->magic)) != 0 ||
+        header->version != recording::kVersion) {
+        std::cerr << "ERROR: '" << path << "' is not a frame recording (or a newer version of one)." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const recording::ChunkHeader* RecordingSource::chunkAt(uint64_t offset) const {
+    if (offset % recording::kAlignment != 0 || offset + sizeof(recording::ChunkHeader) > mappedBytes) {
+        return nullptr;
+    }
+    const auto* chunk = reinterpret_cast<const recording::ChunkHeader*>(mapped + offset);
+    if (chunk->headerBytes != sizeof(recording::ChunkHeader) ||
+        chunk->payloadBytes > mappedBytes - offset - sizeof(recording::ChunkHeader)) {
+        return nullptr;
+    }
+    if (chunk->magic == recording::kFrameMagic) {
+        cv::Mat probe(1, 1, chunk->cvType);
+        if (chunk->rows <= 0 || chunk->cols <= 0 ||
+            static_cast<uint64_t>(chunk->rows) * chunk->cols * probe.elemSize() != chunk->payloadBytes) {
+            return nullptr;
+        }
+    }
+    return chunk;
+}
+
+bool RecordingSource::readIndex() {
+    const auto* header = reinterpret_cast<const recording::FileHeader*>(mapped);
+    if (header->indexOffset == 0) {
+        return false;
+    }
+    const recording::ChunkHeader* chunk = chunkAt(header->indexOffset);
+    if (!chunk || chunk->magic != recording::kIndexMagic ||
+        chunk->payloadBytes != header->frameCount * sizeof(recording::IndexEntry)) {
+        std::cerr << "Warning: Recording index is damaged; scanning frames instead." << std::endl;
+        return false;
+    }
+    const auto* entries = reinterpret_cast<const recording::IndexEntry*>(chunk + 1);
+    index.assign(entries, entries + header->frameCount);
+    index.erase(std::remove_if(index.begin(), index.end(), [this](const recording::IndexEntry& entry) {
+        const recording::ChunkHeader* frame = chunkAt(entry.offset);
+        return !frame || frame->magic != recording::kFrameMagic;
+    }), index.end());
+    return !index.empty();
+}
+
+bool RecordingSource::scanChunks() {
+    // The recorder stopped before writing its index: walk the chunks up to
+    // the first incomplete one.
+    uint64_t offset = sizeof(recording::FileHeader);
+    while (const recording::ChunkHeader* chunk = chunkAt(offset)) {
+        if (chunk->magic != recording::kFrameMagic) {
+            break;
+        }
+        index.push_back({offset, chunk->timestampNs});
+        offset = recording::alignUp(offset + sizeof(*chunk) + chunk->payloadBytes);
+    }
+    if (index.empty()) {
+        std::cerr << "ERROR: Recording contains no frames." << std::endl;
+        return false;
+    }
+    std::cerr << "Warning: Recording has no index (not closed cleanly?); found " << index.size() << " frames." << std::endl;
+    return true;
+}
+
+bool RecordingSource::waitUntilDue(int64_t timestampNs) {
+    auto due = playbackStart + std::chrono::nanoseconds(timestampNs - firstTimestampNs);
+    std::unique_lock<std::mutex> lock(pacingMutex);
+    return !pacingWake.wait_until(lock, due, [this] { return stopRequested(); });
+}
+
+void RecordingSource::interruptProducer() {
+    {
+        std::lock_guard<std::mutex> lock(pacingMutex);
+    }
+    pacingWake.notify_all();
+}
+
+bool RecordingSource::produce(Frame& frame) {
+    if (nextFrame == index.size()) {
+        nextFrame = 0;
+        playbackStart = std::chrono::steady_clock::now();
+    }
+    const recording::IndexEntry& entry = index[nextFrame++];
+    if (followTimestamps && !waitUntilDue(entry.timestampNs)) {
+        return false;
+    }
+
+    const recording::ChunkHeader* chunk = chunkAt(entry.offset);
+    uint8_t* pixels = const_cast<uint8_t*>(mapped + entry.offset + sizeof(*chunk));
+    frame.image = cv::Mat(chunk->rows, chunk->cols, chunk->cvType, pixels);
+    frame.format = static_cast<PixelFormat>(chunk->pixelFormat);
+    frame.timestampNs = steadyClockNs();
+
+    // Start paging in the next frame while this one is uploaded.
+    if (nextFrame < index.size()) {
+        const recording::IndexEntry& upcoming = index[nextFrame];
+        const uint64_t pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+        const uint64_t begin = upcoming.offset / pageSize * pageSize;
+        const uint64_t end = upcoming.offset + sizeof(*chunk) + chunkAt(upcoming.offset)->payloadBytes;
+        ::madvise(const_cast<uint8_t*>(mapped) + begin, end - begin, MADV_WILLNEED);
+    }
+    return true;
+}
+
+bool RecordingSource::isOpened() const {
+    return !index.empty();
+}
+
+int RecordingSource::getWidth() const {
+    return frameWidth;
+}
+
+int RecordingSource::getHeight() const {
+    return frameHeight;
+}
+
+PixelFormat RecordingSource::getPixelFormat() const {
+    return pixelFormat;
+}
@@ -0,0 +1,79 @@
+#include "RenderTarget.h"
+#include <algorithm>
+#include <iostream>
+
+RenderTarget::~RenderTarget() {
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
+
+void RenderTarget::resize(cv::Size newSize) {
+    newSize.width = std::max(1, newSize.width);
+    newSize.height = std::max(1, newSize.height);
+    if (newSize == size && framebuffer != 0) {
+        return;
+    }
+    size = newSize;
+    if (framebuffer == 0) {
+        glGenFramebuffers(1, &framebuffer);
+        glGenRenderbuffers(1, &colorBuffer);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.width, size.height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR: Render target of " << size.width << "x" << size.height << " is incomplete." << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, size.width, size.height);
+}
+
+void RenderTarget::blitToWindow(cv::Size windowSize, Upscale upscale) const {
+    // Window rectangle the render lands in, y up like the framebuffer.
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = windowSize.width;
+    int y1 = windowSize.height;
+    GLenum filter = upscale == Upscale::Linear ? GL_LINEAR : GL_NEAREST;
+    if (upscale == Upscale::Integer) {
+        const int scale = std::min(windowSize.width / size.width, windowSize.height / size.height);
+        if (scale >= 1) {
+            x0 = (windowSize.width - size.width * scale) / 2;
+            y0 = (windowSize.height - size.height * scale) / 2;
+            x1 = x0 + size.width * scale;
+            y1 = y0 + size.height * scale;
+        } else {
+            filter = GL_LINEAR;
+        }
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    if (x0 > 0 || y0 > 0) {
+        // Letterbox bars around an integer-scaled image.
+        glViewport(0, 0, windowSize.width, windowSize.height);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    glBlitFramebuffer(0, 0, size.width, size.height, x0, y0, x1, y1, GL_COLOR_BUFFER_BIT, filter);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool RenderTarget::parseUpscale(const std::string& name, Upscale& upscale) {
+    if (name == "linear") {
+        upscale = Upscale::Linear;
+    } else if (name == "nearest") {
+        upscale = Upscale::Nearest;
+    } else if (name == "integer") {
+        upscale = Upscale::Integer;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "SceneChangeDetector.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+// Every fourth row is plenty to catch motion and keeps the pass well under a
+// millisecond even for 1080p frames.
+constexpr int kRowStep = 4;
+
+uint64_t sumBytes(const uint8_t* data, size_t count) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // psadbw against zero adds up each group of eight bytes into a 64-bit lane.
+    const __m128i zero = _mm_setzero_si128();
+    __m128i accumulator = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        accumulator = _mm_add_epi64(accumulator, _mm_sad_epu8(bytes, zero));
+    }
+    sum = static_cast<uint64_t>(_mm_cvtsi128_si64(accumulator)) +
+          static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(accumulator, accumulator)));
+#elif defined(__ARM_NEON)
+    uint64x2_t accumulator = vdupq_n_u64(0);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t bytes = vld1q_u8(data + i);
+        accumulator = vpadalq_u32(accumulator, vpaddlq_u16(vpaddlq_u8(bytes)));
+    }
+    sum = vgetq_lane_u64(accumulator, 0) + vgetq_lane_u64(accumulator, 1);
+#endif
+    for (; i < count; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+size_t bytesPerPixel(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::YUYV: return 2;
+    case PixelFormat::NV12: return 1; // Luma plane only
+    case PixelFormat::BGR:
+    default: return 3;
+    }
+}
+} // namespace
+
+void SceneChangeDetector::computeSignature(const Frame& frame, std::vector<float>& signature) {
+    const int rows = frame.height();
+    const size_t rowBytes = static_cast<size_t>(frame.width()) * bytesPerPixel(frame.format);
+    signature.assign(kTilesX * kTilesY, 0.0f);
+    tileSums.assign(kTilesX * kTilesY, 0);
+    tileCounts.assign(kTilesX * kTilesY, 0);
+
+    for (int y = 0; y < rows; y += kRowStep) {
+        const uint8_t* row = frame.image.ptr<uint8_t>(y);
+        const int tileY = y * kTilesY / rows;
+        for (int tileX = 0; tileX < kTilesX; ++tileX) {
+            size_t begin = rowBytes * tileX / kTilesX;
+            size_t end = rowBytes * (tileX + 1) / kTilesX;
+            tileSums[tileY * kTilesX + tileX] += sumBytes(row + begin, end - begin);
+            tileCounts[tileY * kTilesX + tileX] += end - begin;
+        }
+    }
+    for (size_t i = 0; i < signature.size(); ++i) {
+        signature[i] = tileCounts[i] ? static_cast<float>(tileSums[i]) / static_cast<float>(tileCounts[i]) : 0.0f;
+    }
+}
+
+bool SceneChangeDetector::hasChanged(const Frame& frame, float tolerance) {
+    if (frame.image.empty()) {
+        return false;
+    }
+    // A new size (reduced-scale decode kicking in) or format always counts as
+    // a change; the GPU copy has to be replaced anyway.
+    const bool sameLayout = !reference.empty() && frame.width() == referenceWidth &&
+                            frame.height() == referenceHeight && frame.format == referenceFormat;
+    if (tolerance <= 0.0f && sameLayout) {
+        return true;
+    }
+
+    computeSignature(frame, current);
+    bool changed = !sameLayout;
+    for (size_t i = 0; !changed && i < current.size(); ++i) {
+        changed = std::fabs(current[i] - reference[i]) > tolerance;
+    }
+    if (changed) {
+        reference.swap(current);
+        referenceWidth = frame.width();
+        referenceHeight = frame.height();
+        referenceFormat = frame.format;
+    }
+    return changed;
+}
@@ -151,25 +151,10 @@ cv::Mat fs::SegmentationModel::infer(const cv::Mat& inputImage) {
     
     context->enqueueV3(stream);
     
-    // Retrieve single output mask from the GPU
-    std::vector<float> outputBuffer(outputElements);
-    cudaMemcpyAsync(outputBuffer.data(), buffers[1], outputBuffer.size() * sizeof(float), cudaMemcpyDeviceToHost, stream);
+    // Retrieve the single output tensor (logits) from the GPU
+    cv::Mat logits(outputHeight, outputWidth, CV_32F);
+    cudaMemcpyAsync(logits.data, buffers[1], outputElements * sizeof(float), cudaMemcpyDeviceToHost, stream);
     
     cudaStreamSynchronize(stream);
-
-    // --- Post-processing for selfie_segmenter ---
-    // 1. Create a Mat from the raw output buffer (which contains logits)
-    cv::Mat outputMask(outputHeight, outputWidth, CV_32F, outputBuffer.data());
-    
-    // 2. Apply a sigmoid function to convert logits to probabilities (0.0 to 1.0)
-    cv::Mat probabilityMask;
-    cv::exp(-outputMask, probabilityMask);
-    probabilityMask = 1.0 / (1.0 + probabilityMask);
-
-    // 3. Resize the small probability mask to the original camera frame size
-    cv::Mat resizedMask;
-    cv::resize(probabilityMask, resizedMask, inputImage.size());
-
-    // 4. Threshold the probabilities to get a binary mask and convert to CV_8UC1
-    return resizedMask > 0.5;
+    return logits;
 }
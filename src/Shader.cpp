@@ -1,9 +1,215 @@
 #include "Shader.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <filesystem>
+#include <set>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
+namespace {
+// Replaces each `#include "file"` line with the contents of that file,
+// resolved relative to the including file. Like #pragma once, a file that
+// was already pulled in is skipped, so includes may include each other.
+// #line directives keep compiler error line numbers pointing at the right place.
+std::string expandIncludes(const std::string& source, const std::filesystem::path& directory,
+                           std::set<std::filesystem::path>& included, int depth = 0) {
+    if (depth > 8) {
+        throw std::ifstream::failure("#include nested too deeply in " + directory.string());
+    }
+    std::istringstream input(source);
+    std::ostringstream output;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+            output << line << '\n';
+            continue;
+        }
+        size_t open = line.find('"', start);
+        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos) {
+            throw std::ifstream::failure("Malformed #include: " + line);
+        }
+        std::filesystem::path includePath = directory / line.substr(open + 1, close - open - 1);
+        if (!included.insert(std::filesystem::weakly_canonical(includePath)).second) {
+            output << '\n';
+            continue;
+        }
+
+        std::ifstream includeFile;
+        includeFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        includeFile.open(includePath);
+        std::stringstream includeStream;
+        includeStream << includeFile.rdbuf();
+
+        output << "#line 1\n"
+               << expandIncludes(includeStream.str(), includePath.parent_path(), included, depth + 1)
+               << "#line " << lineNumber + 1 << '\n';
+    }
+    return output.str();
+}
+
+// GLSL wants #version first, so defines go on the line after it.
+std::string insertDefines(const std::string& source, const std::string& defines) {
+    if (defines.empty()) {
+        return source;
+    }
+    size_t version = source.find("#version");
+    if (version == std::string::npos) {
+        return defines + "#line 1\n" + source;
+    }
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == std::string::npos) {
+        return source + '\n' + defines;
+    }
+    int nextLine = 2 + static_cast<int>(std::count(source.begin(), source.begin() + lineEnd, '\n'));
+    return source.substr(0, lineEnd + 1) + defines + "#line " + std::to_string(nextLine) + '\n' +
+           source.substr(lineEnd + 1);
+}
+
+// GL_COMPLETION_STATUS_KHR, which has the same value in the ARB extension
+constexpr GLenum kCompletionStatus = 0x91B1;
+
+const char kBinaryMagic[4] = {'F', 'S', 'P', 'B'};
+
+// 64-bit FNV-1a, which unlike std::hash is the same on every run.
+void hashBytes(uint64_t& hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    hash ^= 0xff; // Separates consecutive strings
+    hash *= 1099511628211ull;
+}
+
+// A binary is only valid for the driver that produced it, so the driver
+// strings are part of the key along with every stage's expanded source.
+std::string binaryCacheKey(std::initializer_list<const std::string*> sources) {
+    uint64_t hash = 14695981039346656037ull;
+    for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+        hashBytes(hash, value ? value : "", value ? std::strlen(value) : 0);
+    }
+    for (const std::string* source : sources) {
+        hashBytes(hash, source->data(), source->size());
+    }
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+} // namespace
+
+std::string Shader::binaryCacheDirectory;
+bool Shader::parallelCompile = false;
+
+bool Shader::enableParallelCompile(GLADloadproc load) {
+    // glad is generated without the extension, so look for it by hand.
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    const char* entryPoint = nullptr;
+    for (GLint i = 0; i < count; ++i) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0) {
+            entryPoint = "glMaxShaderCompilerThreadsKHR";
+            break;
+        }
+        if (std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0) {
+            entryPoint = "glMaxShaderCompilerThreadsARB";
+        }
+    }
+    using MaxShaderCompilerThreadsFn = void(APIENTRYP)(GLuint count);
+    auto maxShaderCompilerThreads =
+        entryPoint ? reinterpret_cast<MaxShaderCompilerThreadsFn>(load(entryPoint)) : nullptr;
+    if (!maxShaderCompilerThreads) {
+        return false;
+    }
+    // All ones lets the driver choose how many threads to use.
+    maxShaderCompilerThreads(0xFFFFFFFFu);
+    parallelCompile = true;
+    return true;
+}
+
+void Shader::setBinaryCacheDirectory(const std::string& directory) {
+    binaryCacheDirectory = directory;
+    if (directory.empty()) {
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Warning: Could not create shader cache " << directory << ": " << error.message()
+                  << ". Compiling every shader." << std::endl;
+        binaryCacheDirectory.clear();
+    }
+}
+
+bool Shader::loadBinary(const std::string& key) {
+    if (binaryCacheDirectory.empty()) {
+        return false;
+    }
+    std::ifstream file(std::filesystem::path(binaryCacheDirectory) / (key + ".bin"), std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const size_t headerSize = sizeof(kBinaryMagic) + sizeof(GLenum);
+    if (contents.size() <= headerSize || std::memcmp(contents.data(), kBinaryMagic, sizeof(kBinaryMagic)) != 0) {
+        return false;
+    }
+    GLenum format = 0;
+    std::memcpy(&format, contents.data() + sizeof(kBinaryMagic), sizeof(format));
+
+    ID = glCreateProgram();
+    glProgramBinary(ID, format, contents.data() + headerSize, static_cast<GLsizei>(contents.size() - headerSize));
+    if (!isLinked()) {
+        // Typically a driver update; compile as usual and overwrite it.
+        glDeleteProgram(ID);
+        ID = 0;
+        return false;
+    }
+    fromBinaryCache = true;
+    return true;
+}
+
+void Shader::saveBinary(const std::string& key) const {
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (binaryCacheDirectory.empty() || formats == 0 || !isLinked()) {
+        return;
+    }
+    GLint length = 0;
+    glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLenum format = 0;
+    glGetProgramBinary(ID, length, &length, &format, binary.data());
+
+    // Write then rename, so a concurrent run never reads half a file.
+    const std::filesystem::path path = std::filesystem::path(binaryCacheDirectory) / (key + ".bin");
+    const std::filesystem::path temporary = path.string() + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(kBinaryMagic, sizeof(kBinaryMagic));
+        file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+        file.write(binary.data(), length);
+        if (!file) {
+            std::cerr << "Warning: Could not write shader cache " << temporary << std::endl;
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath, const std::string& defines, bool deferred) {
     // 1. Retrieve the vertex/fragment source code from filePath
     std::string vertexCode;
     std::string fragmentCode;
@@ -24,44 +230,114 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
         // Close file handlers
         vShaderFile.close();
         fShaderFile.close();
-        // Convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        // Convert stream into string, expanding any shared includes
+        std::set<std::filesystem::path> vertexIncludes;
+        std::set<std::filesystem::path> fragmentIncludes;
+        vertexCode = insertDefines(
+            expandIncludes(vShaderStream.str(), std::filesystem::path(vertexPath).parent_path(), vertexIncludes),
+            defines);
+        fragmentCode = insertDefines(
+            expandIncludes(fShaderStream.str(), std::filesystem::path(fragmentPath).parent_path(), fragmentIncludes),
+            defines);
+        sourceFiles = {vertexPath, fragmentPath};
+        sourceFiles.insert(sourceFiles.end(), vertexIncludes.begin(), vertexIncludes.end());
+        sourceFiles.insert(sourceFiles.end(), fragmentIncludes.begin(), fragmentIncludes.end());
     }
     catch (std::ifstream::failure& e) {
         std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
     }
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    // 2. Compile shaders
-    unsigned int vertex, fragment;
-
-    // Vertex shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
+    const std::string cacheKey = binaryCacheKey({&vertexCode, &fragmentCode});
+    if (loadBinary(cacheKey)) {
+        return;
+    }
+    build({{GL_VERTEX_SHADER, &vertexCode}, {GL_FRAGMENT_SHADER, &fragmentCode}}, cacheKey);
+    if (!deferred) {
+        finish();
+    }
+}
 
-    // Fragment Shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
+std::unique_ptr<Shader> Shader::compute(const char* computePath, const std::string& defines, bool deferred) {
+    std::string computeCode;
+    std::set<std::filesystem::path> includes;
+    try {
+        std::ifstream computeFile;
+        computeFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        computeFile.open(computePath);
+        std::stringstream computeStream;
+        computeStream << computeFile.rdbuf();
+        computeCode = insertDefines(
+            expandIncludes(computeStream.str(), std::filesystem::path(computePath).parent_path(), includes), defines);
+    }
+    catch (std::ifstream::failure& e) {
+        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        return nullptr;
+    }
+    std::unique_ptr<Shader> shader(new Shader());
+    shader->sourceFiles.assign(includes.begin(), includes.end());
+    shader->sourceFiles.insert(shader->sourceFiles.begin(), computePath);
+    const std::string cacheKey = binaryCacheKey({&computeCode});
+    if (shader->loadBinary(cacheKey)) {
+        return shader;
+    }
+    shader->build({{GL_COMPUTE_SHADER, &computeCode}}, cacheKey);
+    if (deferred) {
+        return shader;
+    }
+    shader->finish();
+    if (!shader->isLinked()) {
+        return nullptr;
+    }
+    return shader;
+}
 
-    // Shader Program
+// Compiling every stage and linking is only queued here: asking for any
+// status would wait for the driver, so errors are looked at in finish().
+void Shader::build(const std::vector<std::pair<GLenum, const std::string*>>& stages, const std::string& cacheKey) {
     ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
+    glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    for (const auto& stage : stages) {
+        const char* code = stage.second->c_str();
+        GLuint shader = glCreateShader(stage.first);
+        glShaderSource(shader, 1, &code, NULL);
+        glCompileShader(shader);
+        glAttachShader(ID, shader);
+        pendingStages.emplace_back(shader, stage.first == GL_VERTEX_SHADER     ? "VERTEX"
+                                           : stage.first == GL_FRAGMENT_SHADER ? "FRAGMENT"
+                                                                               : "COMPUTE");
+    }
     glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
+    pendingCacheKey = cacheKey;
+    pending = true;
+}
 
-    // Delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+bool Shader::isReady() const {
+    if (!pending || !parallelCompile) {
+        return true;
+    }
+    GLint complete = GL_FALSE;
+    glGetProgramiv(ID, kCompletionStatus, &complete);
+    return complete == GL_TRUE;
+}
+
+void Shader::finish() {
+    if (!pending) {
+        return;
+    }
+    pending = false;
+    for (const auto& stage : pendingStages) {
+        checkCompileErrors(stage.first, stage.second);
+        // Delete the shaders as they're linked into our program now and no longer necessary
+        glDeleteShader(stage.first);
+    }
+    pendingStages.clear();
+    checkCompileErrors(ID, "PROGRAM");
+    saveBinary(pendingCacheKey);
 }
 
 Shader::~Shader() {
+    for (const auto& stage : pendingStages) {
+        glDeleteShader(stage.first);
+    }
     glDeleteProgram(ID);
 }
 
@@ -69,6 +345,12 @@ void Shader::use() const {
     glUseProgram(ID);
 }
 
+bool Shader::isLinked() const {
+    GLint linked = GL_FALSE;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
+
 bool Shader::usesUniform(const std::string& name) const {
     // getUniformLocation returns -1 if the uniform is not found.
     return getUniformLocation(name) != -1;
@@ -90,6 +372,10 @@ void Shader::setVec2(const std::string &name, float v1, float v2) const {
     glUniform2f(getUniformLocation(name), v1, v2);
 }
 
+void Shader::setIVec2(const std::string &name, int v1, int v2) const {
+    glUniform2i(getUniformLocation(name), v1, v2);
+}
+
 GLint Shader::getUniformLocation(const std::string &name) const {
     // Check if we already have the location cached
     if (uniformLocationCache.find(name) != uniformLocationCache.end()) {
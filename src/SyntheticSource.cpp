@@ -0,0 +1,60 @@
+#include "SyntheticSource.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Bounces 0 -> range -> 0 as `position` increases.
+int triangleWave(int64_t position, int range) {
+    if (range <= 0) return 0;
+    int64_t period = 2 * static_cast<int64_t>(range);
+    int64_t phase = position % period;
+    return static_cast<int>(phase <= range ? phase : period - phase);
+}
+} // namespace
+
+SyntheticSource::SyntheticSource(int width, int height, const SourceSettings& settings)
+    : frameWidth(width), frameHeight(height), motion(settings.motion) {
+    double fps = settings.fps > 0.0 ? settings.fps : 30.0;
+    std::cout << "Synthetic source: " << frameWidth << "x" << frameHeight << " at "
+              << fps << " fps" << (settings.paced ? "" : " (unpaced)")
+              << ", motion " << motion << " px/frame" << std::endl;
+
+    preallocateSlots(frameWidth, frameHeight, CV_8UC3);
+    start(settings.paced ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / fps))
+                         : std::chrono::nanoseconds::zero());
+}
+
+SyntheticSource::~SyntheticSource() {
+    stop();
+}
+
+bool SyntheticSource::produce(Frame& frame) {
+    frame.image.create(frameHeight, frameWidth, CV_8UC3);
+    const int64_t shift = std::llround(static_cast<double>(motion) * static_cast<double>(frameNumber++));
+
+    // Gradients scroll in different directions so every cell changes
+    // brightness and hue over time.
+    for (int y = 0; y < frameHeight; ++y) {
+        uint8_t* row = frame.image.ptr<uint8_t>(y);
+        const uint8_t green = static_cast<uint8_t>((y + shift / 2) & 0xFF);
+        for (int x = 0; x < frameWidth; ++x) {
+            row[3 * x + 0] = static_cast<uint8_t>((x + shift) & 0xFF);
+            row[3 * x + 1] = green;
+            row[3 * x + 2] = static_cast<uint8_t>(((x + y) / 2 - shift) & 0xFF);
+        }
+    }
+
+    // A bright block bouncing around gives high-contrast edges to track.
+    const int blockSize = std::max(1, std::min(frameWidth, frameHeight) / 4);
+    const int blockX = triangleWave(shift, frameWidth - blockSize);
+    const int blockY = triangleWave(shift * 3 / 5, frameHeight - blockSize);
+    for (int y = blockY; y < blockY + blockSize; ++y) {
+        std::fill_n(frame.image.ptr<uint8_t>(y) + 3 * blockX, 3 * blockSize, static_cast<uint8_t>(255));
+    }
+
+    frame.format = PixelFormat::BGR;
+    frame.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return true;
+}
@@ -0,0 +1,138 @@
+#include "ThreadedFrameSource.h"
+#include <iostream>
+
+ThreadedFrameSource::~ThreadedFrameSource() {
+    stop();
+}
+
+void ThreadedFrameSource::start(std::chrono::nanoseconds frameInterval) {
+    running = true;
+    producerThread = std::thread(&ThreadedFrameSource::producerLoop, this, frameInterval);
+}
+
+void ThreadedFrameSource::stop() {
+    if (!producerThread.joinable()) {
+        return;
+    }
+    stopping = true;
+    interruptProducer();
+    producerThread.join();
+
+    std::cout << "Frame source stopped: " << getCapturedFrames() << " frames captured, "
+              << getDroppedFrames() << " dropped, " << getUnchangedFrames() << " unchanged." << std::endl;
+    for (Frame& slot : ring.allSlots()) {
+        recycle(slot);
+    }
+}
+
+void ThreadedFrameSource::preallocateSlots(int width, int height, int type) {
+    slotWidth = width;
+    slotHeight = height;
+    slotType = type;
+    for (Frame& slot : ring.allSlots()) {
+        slot.image.create(height, width, type);
+    }
+}
+
+size_t ThreadedFrameSource::getSlotBytes() const {
+    if (slotType < 0 || !keepsSlotBuffers()) {
+        return 0;
+    }
+    return static_cast<size_t>(slotWidth) * slotHeight * CV_ELEM_SIZE(slotType);
+}
+
+void ThreadedFrameSource::setSlotStorage(const std::vector<uint8_t*>& slots) {
+    if (getSlotBytes() == 0 || slots.size() != ring.allSlots().size()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(slotStorageMutex);
+    slotStorage = slots;
+}
+
+void ThreadedFrameSource::bindSlotStorage(Frame& slot) {
+    std::lock_guard<std::mutex> lock(slotStorageMutex);
+    if (slotStorage.empty()) {
+        return;
+    }
+    // Only the write slot is ours to touch, so slots move over one at a
+    // time as the ring cycles through them.
+    uint8_t* storage = slotStorage[&slot - ring.allSlots().data()];
+    if (slot.image.data != storage) {
+        slot.image = cv::Mat(slotHeight, slotWidth, slotType, storage);
+    }
+}
+
+void ThreadedFrameSource::producerLoop(std::chrono::nanoseconds frameInterval) {
+    auto nextFrameTime = std::chrono::steady_clock::now();
+    while (!stopRequested()) {
+        if (frameInterval.count() > 0) {
+            std::this_thread::sleep_until(nextFrameTime);
+            nextFrameTime += frameInterval;
+            auto now = std::chrono::steady_clock::now();
+            if (nextFrameTime < now) {
+                nextFrameTime = now; // Running behind: don't try to catch up in a burst
+            }
+        }
+
+        Frame& slot = ring.writeSlot();
+        recycle(slot);
+        bindSlotStorage(slot);
+        if (!produce(slot)) {
+            if (!stopRequested()) {
+                std::cerr << "ERROR: Frame source read failed, stopping capture." << std::endl;
+            }
+            break;
+        }
+        if (sceneDetector.hasChanged(slot, changeTolerance.load(std::memory_order_relaxed))) {
+            ++contentGeneration;
+        } else {
+            unchangedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        slot.contentGeneration = contentGeneration;
+        slot.dequeueNs = steadyClockNs();
+        slot.sequence = capturedFrames.fetch_add(1, std::memory_order_relaxed) + 1;
+        {
+            std::lock_guard<std::mutex> lock(recorderMutex);
+            if (recorder) {
+                recorder->append(slot);
+            }
+        }
+        if (ring.publish()) {
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    running = false;
+}
+
+bool ThreadedFrameSource::isRunning() const {
+    return running.load();
+}
+
+bool ThreadedFrameSource::read(Frame& frame) {
+    if (!ring.acquire()) {
+        return false;
+    }
+    frame = ring.readSlot();
+    return true;
+}
+
+uint64_t ThreadedFrameSource::getCapturedFrames() const {
+    return capturedFrames.load(std::memory_order_relaxed);
+}
+
+uint64_t ThreadedFrameSource::getDroppedFrames() const {
+    return droppedFrames.load(std::memory_order_relaxed);
+}
+
+uint64_t ThreadedFrameSource::getUnchangedFrames() const {
+    return unchangedFrames.load(std::memory_order_relaxed);
+}
+
+void ThreadedFrameSource::setRecorder(std::shared_ptr<FrameRecorder> newRecorder) {
+    std::lock_guard<std::mutex> lock(recorderMutex);
+    recorder = std::move(newRecorder);
+}
+
+void ThreadedFrameSource::setChangeTolerance(float tolerance) {
+    changeTolerance.store(tolerance, std::memory_order_relaxed);
+}
@@ -0,0 +1,320 @@
+#include "V4L2Capture.h"
+#include "CameraModes.h"
+#include "FrameRing.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <linux/videodev2.h>
+#include <algorithm>
+
+namespace {
+// The ring can hold up to this many frames (and so driver buffers) at once.
+// Keep at least two more queued so the driver never runs dry.
+constexpr int kMinBufferCount = FrameRing<Frame>::kSlotCount + 2;
+} // namespace
+
+V4L2Capture::V4L2Capture(const std::string& devicePath, const CameraSettings& settings)
+    : device(V4L2Device::open(devicePath)) {
+    if (!device->isOpen()) {
+        return;
+    }
+
+    v4l2_capability cap{};
+    if (device->ioctl(VIDIOC_QUERYCAP, &cap) == -1) {
+        std::cerr << "ERROR: " << devicePath << " is not a V4L2 device." << std::endl;
+        shutdown();
+        return;
+    }
+    if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(cap.capabilities & V4L2_CAP_STREAMING)) {
+        std::cerr << "ERROR: " << devicePath << " does not support streaming video capture." << std::endl;
+        shutdown();
+        return;
+    }
+
+    // Pick the cheapest mode that reaches the configured size and rate. Drivers
+    // that can't enumerate just get the configured values (YUYV for "auto").
+    CameraMode mode{fourccFromName(settings.pixelFormat), settings.width, settings.height, settings.fps};
+    std::vector<CameraMode> modes = enumerateCameraModes(*device, settings);
+    if (!modes.empty() && !chooseCameraMode(modes, settings, mode)) {
+        std::cerr << "ERROR: " << devicePath << " has no " << settings.pixelFormat << " mode." << std::endl;
+        shutdown();
+        return;
+    }
+    if (mode.fourcc == 0) {
+        mode.fourcc = V4L2_PIX_FMT_YUYV;
+    }
+
+    if (!negotiateFormat(mode.width, mode.height, mode.fourcc) ||
+        !initBuffers(std::max(settings.bufferCount, kMinBufferCount))) {
+        shutdown();
+        return;
+    }
+    setFrameRate(mode.fps);
+
+    for (uint32_t i = 0; i < buffers.size(); ++i) {
+        if (!queueBuffer(i)) {
+            shutdown();
+            return;
+        }
+    }
+    v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (device->ioctl(VIDIOC_STREAMON, &type) == -1) {
+        std::cerr << "ERROR: VIDIOC_STREAMON failed: " << strerror(errno) << std::endl;
+        shutdown();
+        return;
+    }
+    streaming = true;
+
+    if (pixelFormat == V4L2_PIX_FMT_MJPEG) {
+        int threads = settings.decodeThreads;
+        if (threads <= 0) {
+            threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 4);
+        }
+        mjpegDecoder = std::make_unique<MjpegDecoder>(threads);
+        mjpegDequeueThread = std::thread(&V4L2Capture::mjpegDequeueLoop, this);
+    }
+
+    std::cout << "V4L2 capture on " << cap.card << ": " << fourccToString(pixelFormat) << " "
+              << frameWidth << "x" << frameHeight;
+    if (frameRate > 0.0) {
+        std::cout << " at " << frameRate << " fps";
+    }
+    std::cout << ", " << buffers.size() << " buffers" << std::endl;
+}
+
+V4L2Capture::~V4L2Capture() {
+    shutdown();
+}
+
+void V4L2Capture::shutdown() {
+    interrupt();
+    if (mjpegDequeueThread.joinable()) {
+        mjpegDequeueThread.join();
+    }
+    if (mjpegDecoder) {
+        std::cout << "MJPEG decoder: " << mjpegDecoder->getDroppedFrames() << " frames dropped (pool busy), "
+                  << mjpegDecoder->getCorruptFrames() << " corrupt." << std::endl;
+        mjpegDecoder.reset();
+    }
+    if (streaming) {
+        v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        device->ioctl(VIDIOC_STREAMOFF, &type);
+        streaming = false;
+    }
+    for (MappedBuffer& buffer : buffers) {
+        if (buffer.start) device->unmap(buffer.start, buffer.length);
+    }
+    buffers.clear();
+    device.reset();
+}
+
+bool V4L2Capture::negotiateFormat(int width, int height, uint32_t fourcc) {
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = width;
+    fmt.fmt.pix.height = height;
+    fmt.fmt.pix.pixelformat = fourcc;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (device->ioctl(VIDIOC_S_FMT, &fmt) == -1) {
+        std::cerr << "ERROR: VIDIOC_S_FMT failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    pixelFormat = fmt.fmt.pix.pixelformat;
+    if (pixelFormat != V4L2_PIX_FMT_YUYV && pixelFormat != V4L2_PIX_FMT_NV12 &&
+        pixelFormat != V4L2_PIX_FMT_BGR24 && pixelFormat != V4L2_PIX_FMT_MJPEG) {
+        std::cerr << "ERROR: Unsupported V4L2 pixel format " << fourccToString(pixelFormat) << "." << std::endl;
+        return false;
+    }
+    frameWidth = fmt.fmt.pix.width;
+    frameHeight = fmt.fmt.pix.height;
+    bytesPerLine = fmt.fmt.pix.bytesperline;
+    return true;
+}
+
+void V4L2Capture::setFrameRate(double fps) {
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (device->ioctl(VIDIOC_G_PARM, &parm) == -1 || !(parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME)) {
+        return; // Fixed-rate device
+    }
+    if (fps > 0.0) {
+        parm.parm.capture.timeperframe.numerator = 1000;
+        parm.parm.capture.timeperframe.denominator = static_cast<uint32_t>(fps * 1000.0 + 0.5);
+        if (device->ioctl(VIDIOC_S_PARM, &parm) == -1) {
+            std::cerr << "Warning: Could not set the camera to " << fps << " fps: " << strerror(errno) << std::endl;
+        }
+    }
+    const v4l2_fract& interval = parm.parm.capture.timeperframe;
+    frameRate = interval.numerator ? static_cast<double>(interval.denominator) / interval.numerator : 0.0;
+}
+
+bool V4L2Capture::initBuffers(int bufferCount) {
+    v4l2_requestbuffers req{};
+    req.count = bufferCount;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (device->ioctl(VIDIOC_REQBUFS, &req) == -1) {
+        std::cerr << "ERROR: VIDIOC_REQBUFS failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (req.count < 2) {
+        std::cerr << "ERROR: Insufficient V4L2 buffer memory." << std::endl;
+        return false;
+    }
+
+    buffers.resize(req.count);
+    for (uint32_t i = 0; i < req.count; ++i) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (device->ioctl(VIDIOC_QUERYBUF, &buf) == -1) {
+            std::cerr << "ERROR: VIDIOC_QUERYBUF failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        void* start = device->map(buf.length, buf.m.offset);
+        if (start == MAP_FAILED) {
+            std::cerr << "ERROR: mmap of V4L2 buffer " << i << " failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        buffers[i] = {start, buf.length};
+    }
+    return true;
+}
+
+bool V4L2Capture::queueBuffer(uint32_t index) {
+    v4l2_buffer buf{};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = index;
+    if (device->ioctl(VIDIOC_QBUF, &buf) == -1) {
+        std::cerr << "ERROR: VIDIOC_QBUF failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool V4L2Capture::isOpened() const {
+    return streaming;
+}
+
+bool V4L2Capture::dequeueBuffer(v4l2_buffer& buf) {
+    buf = {};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    while (device->ioctl(VIDIOC_DQBUF, &buf) == -1) {
+        if (errno != EAGAIN) {
+            std::cerr << "ERROR: VIDIOC_DQBUF failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (!device->waitReadable(1000)) {
+            if (!stopRequested.load(std::memory_order_relaxed)) {
+                std::cerr << "ERROR: Timed out waiting for a V4L2 frame." << std::endl;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void V4L2Capture::mjpegDequeueLoop() {
+    v4l2_buffer buf{};
+    while (!stopRequested.load(std::memory_order_relaxed) && dequeueBuffer(buf)) {
+        int64_t timestampNs = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000000LL
+                            + static_cast<int64_t>(buf.timestamp.tv_usec) * 1000LL;
+        mjpegDecoder->submit(static_cast<const uint8_t*>(buffers[buf.index].start), buf.bytesused, timestampNs);
+        if (!queueBuffer(buf.index)) {
+            break;
+        }
+    }
+    // Unblock grab() so the camera notices capture has ended.
+    mjpegDecoder->stop();
+}
+
+bool V4L2Capture::grab(Frame& frame) {
+    if (mjpegDecoder) {
+        return mjpegDecoder->next(frame);
+    }
+
+    release(frame);
+
+    v4l2_buffer buf{};
+    if (!dequeueBuffer(buf)) {
+        return false;
+    }
+
+    frame.timestampNs = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000000LL
+                      + static_cast<int64_t>(buf.timestamp.tv_usec) * 1000LL;
+
+    // Hand out the driver buffer itself; it is requeued once the frame is released.
+    void* data = buffers[buf.index].start;
+    switch (pixelFormat) {
+    case V4L2_PIX_FMT_NV12:
+        frame.image = cv::Mat(frameHeight * 3 / 2, frameWidth, CV_8UC1, data, bytesPerLine);
+        frame.format = PixelFormat::NV12;
+        break;
+    case V4L2_PIX_FMT_BGR24:
+        frame.image = cv::Mat(frameHeight, frameWidth, CV_8UC3, data, bytesPerLine);
+        frame.format = PixelFormat::BGR;
+        break;
+    default:
+        frame.image = cv::Mat(frameHeight, frameWidth, CV_8UC2, data, bytesPerLine);
+        frame.format = PixelFormat::YUYV;
+        break;
+    }
+    frame.bufferIndex = static_cast<int>(buf.index);
+    return true;
+}
+
+void V4L2Capture::release(Frame& frame) {
+    if (frame.bufferIndex < 0) {
+        return;
+    }
+    // Drop the header first so nothing references the buffer once the driver owns it again.
+    frame.image.release();
+    queueBuffer(static_cast<uint32_t>(frame.bufferIndex));
+    frame.bufferIndex = -1;
+}
+
+int V4L2Capture::getWidth() const {
+    return frameWidth;
+}
+
+int V4L2Capture::getHeight() const {
+    return frameHeight;
+}
+
+bool V4L2Capture::fillsFrameStorage() const {
+    return mjpegDecoder != nullptr;
+}
+
+bool V4L2Capture::swapsFrameStorage() const {
+    return mjpegDecoder != nullptr; // MjpegDecoder::next() swaps buffers
+}
+
+void V4L2Capture::interrupt() {
+    stopRequested = true;
+    if (mjpegDecoder) {
+        mjpegDecoder->stop();
+    }
+}
+
+void V4L2Capture::setTargetResolution(int width, int height) {
+    if (mjpegDecoder) {
+        mjpegDecoder->setMinimumSize(width, height);
+    }
+}
+
+PixelFormat V4L2Capture::getPixelFormat() const {
+    switch (pixelFormat) {
+    case V4L2_PIX_FMT_NV12: return PixelFormat::NV12;
+    case V4L2_PIX_FMT_BGR24:
+    case V4L2_PIX_FMT_MJPEG: return PixelFormat::BGR;
+    default: return PixelFormat::YUYV;
+    }
+}
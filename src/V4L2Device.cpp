@@ -0,0 +1,383 @@
+#include "V4L2Device.h"
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <deque>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/videodev2.h>
+
+namespace {
+
+class SystemV4L2Device : public V4L2Device {
+public:
+    explicit SystemV4L2Device(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK);
+        if (fd < 0) {
+            std::cerr << "ERROR: Could not open V4L2 device " << path << ": " << strerror(errno) << std::endl;
+        }
+    }
+
+    ~SystemV4L2Device() override {
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool isOpen() const override { return fd >= 0; }
+
+    int ioctl(unsigned long request, void* arg) override {
+        int result;
+        do {
+            result = ::ioctl(fd, request, arg);
+        } while (result == -1 && errno == EINTR);
+        return result;
+    }
+
+    void* map(size_t length, off_t offset) override {
+        return ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    }
+
+    void unmap(void* address, size_t length) override {
+        ::munmap(address, length);
+    }
+
+    bool waitReadable(int timeoutMs) override {
+        pollfd pfd{fd, POLLIN, 0};
+        int result;
+        do {
+            result = ::poll(&pfd, 1, timeoutMs);
+        } while (result == -1 && errno == EINTR);
+        return result > 0 && (pfd.revents & POLLIN);
+    }
+
+private:
+    int fd = -1;
+};
+
+// Emulates a streaming capture driver on top of a file of frames. For raw
+// formats it derives the frame size from whatever format the caller asks
+// for, so the same recording can stand in for any negotiated size. For MJPEG
+// the file is a concatenation of JPEG images (ffmpeg -f mjpeg writes this).
+// Mode enumeration mimics a USB 2.0 webcam: raw formats only reach the
+// frame rates that fit the bus, MJPEG always runs at up to 30 fps.
+class FakeV4L2Device : public V4L2Device {
+public:
+    explicit FakeV4L2Device(const std::string& path) {
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "ERROR: Could not open fake V4L2 source " << path << ": " << strerror(errno) << std::endl;
+            return;
+        }
+        struct stat st{};
+        fstat(fd, &st);
+        fileSize = static_cast<size_t>(st.st_size);
+        void* mapped = fileSize ? ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        if (mapped == MAP_FAILED) {
+            std::cerr << "ERROR: Could not map fake V4L2 source " << path << "." << std::endl;
+            ::close(fd);
+            fd = -1;
+            return;
+        }
+        fileData = static_cast<const uint8_t*>(mapped);
+        isJpegFile = fileSize > 2 && fileData[0] == 0xFF && fileData[1] == 0xD8;
+        if (isJpegFile) {
+            readJpegSize();
+        }
+    }
+
+    ~FakeV4L2Device() override {
+        if (fileData) ::munmap(const_cast<uint8_t*>(fileData), fileSize);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool isOpen() const override { return fd >= 0; }
+
+    int ioctl(unsigned long request, void* arg) override {
+        switch (request) {
+        case VIDIOC_QUERYCAP: {
+            auto* cap = static_cast<v4l2_capability*>(arg);
+            *cap = {};
+            strncpy(reinterpret_cast<char*>(cap->driver), "fake", sizeof(cap->driver) - 1);
+            strncpy(reinterpret_cast<char*>(cap->card), "File-backed fake camera", sizeof(cap->card) - 1);
+            cap->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+            cap->device_caps = cap->capabilities;
+            return 0;
+        }
+        case VIDIOC_ENUM_FMT:
+            return enumFormat(static_cast<v4l2_fmtdesc*>(arg));
+        case VIDIOC_ENUM_FRAMESIZES:
+            return enumFrameSize(static_cast<v4l2_frmsizeenum*>(arg));
+        case VIDIOC_ENUM_FRAMEINTERVALS:
+            return enumFrameInterval(static_cast<v4l2_frmivalenum*>(arg));
+        case VIDIOC_G_PARM:
+        case VIDIOC_S_PARM:
+            return streamParameters(request == VIDIOC_S_PARM, static_cast<v4l2_streamparm*>(arg));
+        case VIDIOC_S_FMT:
+            return setFormat(static_cast<v4l2_format*>(arg));
+        case VIDIOC_G_FMT:
+            *static_cast<v4l2_format*>(arg) = format;
+            return 0;
+        case VIDIOC_REQBUFS:
+            return requestBuffers(static_cast<v4l2_requestbuffers*>(arg));
+        case VIDIOC_QUERYBUF: {
+            auto* buf = static_cast<v4l2_buffer*>(arg);
+            if (buf->index >= buffers.size()) return fail(EINVAL);
+            buf->length = static_cast<uint32_t>(frameSize);
+            buf->m.offset = static_cast<uint32_t>(buf->index * frameSize);
+            return 0;
+        }
+        case VIDIOC_QBUF: {
+            auto* buf = static_cast<v4l2_buffer*>(arg);
+            if (buf->index >= buffers.size()) return fail(EINVAL);
+            queued.push_back(buf->index);
+            return 0;
+        }
+        case VIDIOC_DQBUF:
+            return dequeue(static_cast<v4l2_buffer*>(arg));
+        case VIDIOC_STREAMON:
+            streaming = true;
+            nextFrameTime = std::chrono::steady_clock::now();
+            return 0;
+        case VIDIOC_STREAMOFF:
+            streaming = false;
+            queued.clear();
+            return 0;
+        default:
+            return fail(ENOTTY);
+        }
+    }
+
+    void* map(size_t length, off_t offset) override {
+        size_t index = frameSize ? static_cast<size_t>(offset) / frameSize : buffers.size();
+        if (index >= buffers.size() || length > buffers[index].size()) return MAP_FAILED;
+        return buffers[index].data();
+    }
+
+    void unmap(void*, size_t) override {}
+
+    bool waitReadable(int timeoutMs) override {
+        if (!streaming || queued.empty()) return false;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        if (nextFrameTime > deadline) {
+            std::this_thread::sleep_until(deadline);
+            return false;
+        }
+        std::this_thread::sleep_until(nextFrameTime);
+        return true;
+    }
+
+private:
+    static int fail(int error) {
+        errno = error;
+        return -1;
+    }
+
+    std::vector<uint32_t> offeredFormats() const {
+        if (isJpegFile) return {V4L2_PIX_FMT_MJPEG};
+        return {V4L2_PIX_FMT_YUYV, V4L2_PIX_FMT_NV12, V4L2_PIX_FMT_BGR24};
+    }
+
+    int enumFormat(v4l2_fmtdesc* desc) {
+        std::vector<uint32_t> formats = offeredFormats();
+        if (desc->type != V4L2_BUF_TYPE_VIDEO_CAPTURE || desc->index >= formats.size()) return fail(EINVAL);
+        desc->pixelformat = formats[desc->index];
+        desc->flags = desc->pixelformat == V4L2_PIX_FMT_MJPEG ? V4L2_FMT_FLAG_COMPRESSED : 0;
+        return 0;
+    }
+
+    int enumFrameSize(v4l2_frmsizeenum* size) {
+        static const v4l2_frmsize_discrete rawSizes[] = {{640, 480}, {1280, 720}, {1920, 1080}};
+        std::vector<uint32_t> formats = offeredFormats();
+        if (std::find(formats.begin(), formats.end(), size->pixel_format) == formats.end()) {
+            return fail(EINVAL);
+        }
+        size->type = V4L2_FRMSIZE_TYPE_DISCRETE;
+        if (size->pixel_format == V4L2_PIX_FMT_MJPEG) {
+            if (size->index != 0) return fail(EINVAL);
+            size->discrete = {jpegWidth, jpegHeight};
+        } else {
+            if (size->index >= std::size(rawSizes)) return fail(EINVAL);
+            size->discrete = rawSizes[size->index];
+        }
+        return 0;
+    }
+
+    int enumFrameInterval(v4l2_frmivalenum* interval) {
+        static const uint32_t rates[] = {30, 15, 10, 5};
+        // Roughly what a USB 2.0 isochronous endpoint can carry.
+        const double busBytesPerSecond = 24e6;
+        double bytesPerPixel = interval->pixel_format == V4L2_PIX_FMT_NV12 ? 1.5
+                             : interval->pixel_format == V4L2_PIX_FMT_BGR24 ? 3.0 : 2.0;
+        std::vector<uint32_t> available;
+        for (uint32_t rate : rates) {
+            double bytesPerSecond = interval->width * interval->height * bytesPerPixel * rate;
+            if (interval->pixel_format == V4L2_PIX_FMT_MJPEG || bytesPerSecond <= busBytesPerSecond) {
+                available.push_back(rate);
+            }
+        }
+        if (available.empty()) available.push_back(rates[3]);
+        if (interval->index >= available.size()) return fail(EINVAL);
+        interval->type = V4L2_FRMIVAL_TYPE_DISCRETE;
+        interval->discrete = {1, available[interval->index]};
+        return 0;
+    }
+
+    int streamParameters(bool set, v4l2_streamparm* parm) {
+        if (parm->type != V4L2_BUF_TYPE_VIDEO_CAPTURE) return fail(EINVAL);
+        v4l2_fract& timePerFrame = parm->parm.capture.timeperframe;
+        if (set && timePerFrame.numerator && timePerFrame.denominator) {
+            frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(timePerFrame.numerator) / timePerFrame.denominator));
+        }
+        parm->parm.capture = {};
+        parm->parm.capture.capability = V4L2_CAP_TIMEPERFRAME;
+        timePerFrame.numerator = static_cast<uint32_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(frameInterval).count());
+        timePerFrame.denominator = 1000000000;
+        return 0;
+    }
+
+    // Frame size from the first JPEG's start-of-frame marker.
+    void readJpegSize() {
+        for (size_t i = 2; i + 9 < fileSize; ++i) {
+            if (fileData[i] == 0xFF && fileData[i + 1] >= 0xC0 && fileData[i + 1] <= 0xC2) {
+                jpegHeight = (fileData[i + 5] << 8) | fileData[i + 6];
+                jpegWidth = (fileData[i + 7] << 8) | fileData[i + 8];
+                return;
+            }
+        }
+    }
+
+    int setFormat(v4l2_format* fmt) {
+        if (fmt->type != V4L2_BUF_TYPE_VIDEO_CAPTURE) return fail(EINVAL);
+        v4l2_pix_format& pix = fmt->fmt.pix;
+        switch (pix.pixelformat) {
+        case V4L2_PIX_FMT_YUYV:  pix.bytesperline = pix.width * 2; pix.sizeimage = pix.bytesperline * pix.height; break;
+        case V4L2_PIX_FMT_BGR24: pix.bytesperline = pix.width * 3; pix.sizeimage = pix.bytesperline * pix.height; break;
+        case V4L2_PIX_FMT_NV12:  pix.bytesperline = pix.width; pix.sizeimage = pix.width * pix.height * 3 / 2; break;
+        case V4L2_PIX_FMT_MJPEG:
+            indexJpegFrames();
+            if (jpegWidth && jpegHeight) {
+                pix.width = jpegWidth;
+                pix.height = jpegHeight;
+            }
+            pix.bytesperline = 0;
+            pix.sizeimage = static_cast<uint32_t>(largestFrame);
+            break;
+        default:
+            // Unknown formats are answered with YUYV, like a driver would.
+            pix.pixelformat = V4L2_PIX_FMT_YUYV;
+            pix.bytesperline = pix.width * 2;
+            pix.sizeimage = pix.bytesperline * pix.height;
+            break;
+        }
+        pix.field = V4L2_FIELD_NONE;
+        format = *fmt;
+        frameSize = pix.sizeimage;
+        if (pix.pixelformat != V4L2_PIX_FMT_MJPEG) {
+            frames.clear();
+            for (size_t offset = 0; frameSize && offset + frameSize <= fileSize; offset += frameSize) {
+                frames.push_back({offset, frameSize});
+            }
+        }
+        if (frameSize == 0 || frames.empty()) {
+            std::cerr << "ERROR: Fake V4L2 source holds no complete " << pix.width << "x" << pix.height << " frame." << std::endl;
+            return fail(EINVAL);
+        }
+        return 0;
+    }
+
+    int requestBuffers(v4l2_requestbuffers* req) {
+        if (req->memory != V4L2_MEMORY_MMAP) return fail(EINVAL);
+        buffers.assign(req->count, std::vector<uint8_t>(frameSize));
+        queued.clear();
+        return 0;
+    }
+
+    int dequeue(v4l2_buffer* buf) {
+        if (!streaming || queued.empty()) return fail(EAGAIN);
+        if (std::chrono::steady_clock::now() < nextFrameTime) return fail(EAGAIN);
+
+        uint32_t index = queued.front();
+        queued.pop_front();
+
+        const FrameSpan& span = frames[sequence % frames.size()];
+        std::memcpy(buffers[index].data(), fileData + span.offset, span.size);
+
+        timespec now{};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        buf->index = index;
+        buf->bytesused = static_cast<uint32_t>(span.size);
+        buf->flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+        buf->field = V4L2_FIELD_NONE;
+        buf->timestamp.tv_sec = now.tv_sec;
+        buf->timestamp.tv_usec = now.tv_nsec / 1000;
+        buf->sequence = static_cast<uint32_t>(sequence++);
+
+        // Like a driver with no queued buffers, skip frames we fell behind on
+        // instead of delivering a burst.
+        nextFrameTime += frameInterval;
+        auto current = std::chrono::steady_clock::now();
+        if (nextFrameTime < current) {
+            nextFrameTime = current + frameInterval;
+        }
+        return 0;
+    }
+
+    // Splits the file at JPEG start-of-image markers.
+    void indexJpegFrames() {
+        frames.clear();
+        largestFrame = 0;
+        size_t start = std::string::npos;
+        for (size_t i = 0; i + 2 < fileSize; ++i) {
+            if (fileData[i] == 0xFF && fileData[i + 1] == 0xD8 && fileData[i + 2] == 0xFF) {
+                if (start != std::string::npos) frames.push_back({start, i - start});
+                start = i;
+            }
+        }
+        if (start != std::string::npos) frames.push_back({start, fileSize - start});
+        for (const FrameSpan& span : frames) {
+            largestFrame = std::max(largestFrame, span.size);
+        }
+    }
+
+    struct FrameSpan {
+        size_t offset;
+        size_t size;
+    };
+
+    int fd = -1;
+    const uint8_t* fileData = nullptr;
+    size_t fileSize = 0;
+    size_t frameSize = 0;
+    size_t largestFrame = 0;
+    bool isJpegFile = false;
+    uint32_t jpegWidth = 0;
+    uint32_t jpegHeight = 0;
+    std::vector<FrameSpan> frames;
+    v4l2_format format{};
+    std::vector<std::vector<uint8_t>> buffers;
+    std::deque<uint32_t> queued;
+    bool streaming = false;
+    uint64_t sequence = 0;
+    std::chrono::steady_clock::duration frameInterval = std::chrono::microseconds(33333);
+    std::chrono::steady_clock::time_point nextFrameTime;
+};
+
+} // namespace
+
+std::unique_ptr<V4L2Device> V4L2Device::open(const std::string& path) {
+    const std::string fakePrefix = "fake:";
+    if (path.compare(0, fakePrefix.size(), fakePrefix) == 0) {
+        return std::make_unique<FakeV4L2Device>(path.substr(fakePrefix.size()));
+    }
+    return std::make_unique<SystemV4L2Device>(path);
+}
@@ -0,0 +1,54 @@
+#include "VideoFileSource.h"
+#include <iostream>
+
+VideoFileSource::VideoFileSource(const SourceSettings& settings) {
+    cap.open(settings.path, cv::CAP_ANY);
+    if (!cap.isOpened()) {
+        std::cerr << "ERROR: Could not open video file '" << settings.path << "'." << std::endl;
+        return;
+    }
+
+    frameWidth = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+    frameHeight = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+
+    double fps = settings.fps > 0.0 ? settings.fps : cap.get(cv::CAP_PROP_FPS);
+    if (fps <= 0.0) {
+        fps = 30.0;
+    }
+    std::cout << "Video file " << settings.path << ": " << frameWidth << "x" << frameHeight << " at "
+              << fps << " fps" << (settings.paced ? "" : " (unpaced)") << std::endl;
+
+    preallocateSlots(frameWidth, frameHeight, CV_8UC3);
+    start(settings.paced ? std::chrono::nanoseconds(static_cast<int64_t>(1e9 / fps))
+                         : std::chrono::nanoseconds::zero());
+}
+
+VideoFileSource::~VideoFileSource() {
+    stop();
+}
+
+bool VideoFileSource::produce(Frame& frame) {
+    if (!cap.read(frame.image) || frame.image.empty()) {
+        // End of file: rewind and keep playing.
+        cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+        if (!cap.read(frame.image) || frame.image.empty()) {
+            return false;
+        }
+    }
+    frame.format = PixelFormat::BGR;
+    frame.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return true;
+}
+
+bool VideoFileSource::isOpened() const {
+    return cap.isOpened();
+}
+
+int VideoFileSource::getWidth() const {
+    return frameWidth;
+}
+
+int VideoFileSource::getHeight() const {
+    return frameHeight;
+}
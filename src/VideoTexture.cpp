@@ -0,0 +1,334 @@
+#include "VideoTexture.h"
+#include "CellGridReducer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace {
+void initPlane(GLuint texture, GLenum unit, GLint filter) {
+    glActiveTexture(unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void allocatePlane(GLenum unit, GLuint texture, GLint internalFormat, int width, int height, int layers,
+                   GLenum format) {
+    glActiveTexture(unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layers, 0, format, GL_UNSIGNED_BYTE, nullptr);
+}
+
+// Uploads rows that may be padded (driver buffers often are) into one layer.
+void uploadPlane(GLenum unit, GLuint texture, int layer, int width, int height, GLenum format,
+                 size_t bytesPerPixel, const unsigned char* data, size_t step) {
+    glActiveTexture(unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(step / bytesPerPixel));
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+// Upper bound for one fence wait; a GPU that takes longer than this to copy
+// a frame is hung, and the upload goes ahead regardless.
+constexpr GLuint64 kFenceTimeoutNs = 100000000;
+} // namespace
+
+VideoTexture::VideoTexture(int layerCount, int uploadBuffers)
+    : layerSizes(std::clamp(layerCount, 1, kMaxLayers)), uploadBuffers(std::max(0, uploadBuffers)) {
+    glGenTextures(2, planes);
+    initPlane(planes[0], kLumaUnit, GL_LINEAR);
+    initPlane(planes[1], kChromaUnit, GL_LINEAR);
+    // One texel per cell, read at cell centres: no filtering wanted.
+    glGenTextures(1, &cellTexture);
+    initPlane(cellTexture, kCellUnit, GL_NEAREST);
+
+    stagingBuffers.resize(static_cast<size_t>(this->uploadBuffers) * layerSizes.size());
+    nextStagingBuffer.assign(layerSizes.size(), 0);
+    captureBuffers.resize(layerSizes.size());
+    for (StagingBuffer& staging : stagingBuffers) {
+        glGenBuffers(1, &staging.buffer);
+    }
+}
+
+VideoTexture::~VideoTexture() {
+    for (CaptureBuffer& capture : captureBuffers) {
+        if (capture.fence) {
+            glDeleteSync(capture.fence);
+        }
+        if (capture.buffer) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, capture.buffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            glDeleteBuffers(1, &capture.buffer);
+        }
+    }
+    for (StagingBuffer& staging : stagingBuffers) {
+        if (staging.fence) {
+            glDeleteSync(staging.fence);
+        }
+        glDeleteBuffers(1, &staging.buffer);
+    }
+    glDeleteTextures(2, planes);
+    glDeleteTextures(1, &cellTexture);
+}
+
+void VideoTexture::waitAndDelete(GLsync& fence) {
+    if (!fence) {
+        return;
+    }
+    // Poll first so the common case (the GPU finished long ago) stays out
+    // of the wait statistics.
+    if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        const int64_t waitStartNs = steadyClockNs();
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+        const int64_t waitedNs = steadyClockNs() - waitStartNs;
+        ++uploadStats.fenceWaits;
+        uploadStats.fenceWaitNs += waitedNs;
+        uploadStats.maxFenceWaitNs = std::max(uploadStats.maxFenceWaitNs, waitedNs);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+std::vector<uint8_t*> VideoTexture::mapCaptureSlots(int layer, int slotCount, size_t slotBytes) {
+    if (layer < 0 || layer >= getLayerCount() || slotCount <= 0 || slotBytes == 0 ||
+        captureBuffers[layer].buffer != 0) {
+        return {};
+    }
+    // Page-aligned slots keep the capture thread's writes tidy.
+    const size_t stride = (slotBytes + 4095) & ~static_cast<size_t>(4095);
+    const size_t size = stride * slotCount;
+    // The capture thread also reads these pixels back (change detection,
+    // segmentation), so ask for cached client memory rather than
+    // write-combined video memory.
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    CaptureBuffer& capture = captureBuffers[layer];
+    glGenBuffers(1, &capture.buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, capture.buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, flags | GL_CLIENT_STORAGE_BIT);
+    capture.mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(size), flags));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (!capture.mapped) {
+        glDeleteBuffers(1, &capture.buffer);
+        capture = CaptureBuffer();
+        return {};
+    }
+    capture.size = size;
+
+    std::vector<uint8_t*> slots;
+    for (int i = 0; i < slotCount; ++i) {
+        slots.push_back(capture.mapped + stride * i);
+    }
+    return slots;
+}
+
+void VideoTexture::waitForCaptureSlot(int layer) {
+    if (layer >= 0 && layer < getLayerCount()) {
+        waitAndDelete(captureBuffers[layer].fence);
+    }
+}
+
+VideoTexture::StagingBuffer* VideoTexture::stage(const cv::Mat& image, int layer) {
+    if (uploadBuffers == 0) {
+        return nullptr;
+    }
+    int& next = nextStagingBuffer[layer];
+    StagingBuffer& staging = stagingBuffers[static_cast<size_t>(layer) * uploadBuffers + next];
+    next = (next + 1) % uploadBuffers;
+    waitAndDelete(staging.fence);
+
+    const size_t bytes = image.step * (image.rows - 1) + image.cols * image.elemSize();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.buffer);
+    if (staging.capacity < bytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        staging.capacity = bytes;
+    }
+    // The fence already guarantees the GPU is done with this buffer, so the
+    // driver need not synchronise the mapping again.
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped) {
+        std::memcpy(mapped, image.data, bytes);
+    }
+    if (!mapped || glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) != GL_TRUE) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return nullptr;
+    }
+    return &staging;
+}
+
+void VideoTexture::allocate(PixelFormat newFormat, int newWidth, int newHeight) {
+    format = newFormat;
+    width = newWidth;
+    height = newHeight;
+    ++storageGeneration;
+    const int layers = getLayerCount();
+
+    // Packed YUYV texels hold two pixels each, so filtering across them would
+    // blend luma of different pixels; video.glsl fetches them explicitly.
+    GLint lumaFilter = format == PixelFormat::YUYV ? GL_NEAREST : GL_LINEAR;
+    initPlane(planes[0], kLumaUnit, lumaFilter);
+
+    switch (format) {
+    case PixelFormat::YUYV:
+        allocatePlane(kLumaUnit, planes[0], GL_RGBA8, width / 2, height, layers, GL_RGBA);
+        break;
+    case PixelFormat::NV12:
+        allocatePlane(kLumaUnit, planes[0], GL_R8, width, height, layers, GL_RED);
+        allocatePlane(kChromaUnit, planes[1], GL_RG8, width / 2, height / 2, layers, GL_RG);
+        break;
+    case PixelFormat::BGR:
+    default:
+        allocatePlane(kLumaUnit, planes[0], GL_RGB8, width, height, layers, GL_BGR);
+        break;
+    }
+}
+
+void VideoTexture::upload(const Frame& frame, int layer) {
+    if (frame.image.empty() || layer < 0 || layer >= getLayerCount()) {
+        return;
+    }
+
+    // Storage follows the largest current layer, so it also shrinks again
+    // when reduced-scale decode kicks in.
+    layerSizes[layer] = cv::Size(frame.width(), frame.height());
+    int requiredWidth = 0;
+    int requiredHeight = 0;
+    for (const cv::Size& size : layerSizes) {
+        requiredWidth = std::max(requiredWidth, size.width);
+        requiredHeight = std::max(requiredHeight, size.height);
+    }
+    if (frame.format != format || requiredWidth != width || requiredHeight != height) {
+        allocate(frame.format, requiredWidth, requiredHeight);
+    }
+
+    const cv::Mat& image = frame.image;
+    const int frameWidth = frame.width();
+    const int frameHeight = frame.height();
+    const size_t bytes = image.step * (image.rows - 1) + image.cols * image.elemSize();
+
+    // Pixels already in the capture buffer need no copy at all; anything
+    // else goes through a staging buffer if there is one.
+    CaptureBuffer& capture = captureBuffers[layer];
+    const bool captured = capture.mapped && image.data >= capture.mapped &&
+                          image.data + bytes <= capture.mapped + capture.size;
+    StagingBuffer* staging = nullptr;
+    size_t bufferOffset = 0;
+    if (captured) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, capture.buffer);
+        bufferOffset = static_cast<size_t>(image.data - capture.mapped);
+    } else {
+        staging = stage(image, layer);
+    }
+    // Pixels in a bound buffer are addressed by their offset into it.
+    auto pixels = [&](size_t offset) -> const unsigned char* {
+        if (captured || staging) {
+            return reinterpret_cast<const unsigned char*>(bufferOffset + offset);
+        }
+        return image.data + offset;
+    };
+    if (profiler) {
+        profiler->begin(LatencyTracker::GpuUpload);
+    }
+    switch (format) {
+    case PixelFormat::YUYV:
+        uploadPlane(kLumaUnit, planes[0], layer, frameWidth / 2, frameHeight, GL_RGBA, 4, pixels(0), image.step);
+        break;
+    case PixelFormat::NV12:
+        uploadPlane(kLumaUnit, planes[0], layer, frameWidth, frameHeight, GL_RED, 1, pixels(0), image.step);
+        uploadPlane(kChromaUnit, planes[1], layer, frameWidth / 2, frameHeight / 2, GL_RG, 2,
+                    pixels(image.step * frameHeight), image.step);
+        break;
+    case PixelFormat::BGR:
+    default:
+        uploadPlane(kLumaUnit, planes[0], layer, frameWidth, frameHeight, GL_BGR, 3, pixels(0), image.step);
+        break;
+    }
+    if (profiler) {
+        profiler->end(LatencyTracker::GpuUpload);
+    }
+    ++uploadStats.uploads;
+    if (captured) {
+        ++uploadStats.zeroCopyUploads;
+        if (capture.fence) {
+            glDeleteSync(capture.fence); // Superseded: this upload finishes later
+        }
+        capture.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else if (staging) {
+        staging->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
+
+void VideoTexture::setCellGrid(cv::Size2f extent) {
+    cellExtent = cv::Size2f(std::max(1.0f, extent.width), std::max(1.0f, extent.height));
+    const cv::Size grid(static_cast<int>(std::ceil(cellExtent.width)), static_cast<int>(std::ceil(cellExtent.height)));
+    if (cellGrid == grid) {
+        return;
+    }
+    cellGrid = grid;
+    allocatePlane(kCellUnit, cellTexture, GL_RGBA8, grid.width, grid.height, getLayerCount(), GL_BGRA);
+}
+
+void VideoTexture::uploadCells(const Frame& frame, int layer) {
+    if (frame.image.empty() || cellGrid.empty() || layer < 0 || layer >= getLayerCount()) {
+        return;
+    }
+    CellGridReducer::reduce(frame, cellExtent, cellScratch);
+    if (profiler) {
+        profiler->begin(LatencyTracker::GpuUpload);
+    }
+    uploadPlane(kCellUnit, cellTexture, layer, cellScratch.cols, cellScratch.rows, GL_BGRA, 4, cellScratch.data,
+                cellScratch.step);
+    if (profiler) {
+        profiler->end(LatencyTracker::GpuUpload);
+    }
+}
+
+void VideoTexture::reduceCells(const Shader& program, int layer) const {
+    if (cellGrid.empty() || width == 0 || height == 0 || layer < 0 || layer >= getLayerCount()) {
+        return;
+    }
+    bind();
+    program.use();
+    program.setInt("videoFormat", static_cast<int>(format));
+    cv::Point2f scale = getLayerScale(layer);
+    program.setVec2("videoLayerScale[" + std::to_string(layer) + "]", scale.x, scale.y);
+    program.setInt("cellLayer", layer);
+    program.setVec2("cellExtent", cellExtent.width, cellExtent.height);
+
+    glBindImageTexture(0, cellTexture, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    if (profiler) {
+        profiler->begin(LatencyTracker::GpuCellGrid);
+    }
+    glDispatchCompute((cellGrid.width + 7) / 8, (cellGrid.height + 7) / 8, 1);
+    if (profiler) {
+        profiler->end(LatencyTracker::GpuCellGrid);
+    }
+    // The shaders sample the result as a texture in the next draw.
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+cv::Point2f VideoTexture::getLayerScale(int layer) const {
+    if (layer < 0 || layer >= getLayerCount() || width == 0 || height == 0) {
+        return cv::Point2f(1.0f, 1.0f);
+    }
+    return cv::Point2f(static_cast<float>(layerSizes[layer].width) / width,
+                       static_cast<float>(layerSizes[layer].height) / height);
+}
+
+void VideoTexture::bind() const {
+    glActiveTexture(kLumaUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, planes[0]);
+    glActiveTexture(kChromaUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, planes[1]);
+    glActiveTexture(kCellUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, cellTexture);
+}